@@ -14,6 +14,8 @@ import AltKit
 
 import ShowTouches
 
+import SDWebImage
+
 private extension CFNotificationName
 {
     static let altstoreRequestAppState: CFNotificationName = CFNotificationName("com.altstore.RequestAppState.com.rileytestut.Delta" as CFString)
@@ -40,6 +42,7 @@ class AppDelegate: UIResponder, UIApplicationDelegate
         
         self.registerCores()
         self.configureAppearance()
+        self.configureImageCaches()
         self.updateSettings()
         
         // Controllers
@@ -169,6 +172,15 @@ private extension AppDelegate
         self.window?.tintColor = UIColor.deltaPurple
     }
     
+    func configureImageCaches()
+    {
+        // SDImageCache doesn't charge images by their decoded size, and artwork is already cached at display size by ThumbnailCache,
+        // so don't also keep full-size artwork in memory. SDImageCache only needs to cache downloaded files on disk.
+        let imageCache = SDImageCache.shared()
+        imageCache?.shouldCacheImagesInMemory = false
+        imageCache?.maxCacheSize = 64 * 1024 * 1024
+    }
+    
     func updateSettings()
     {
         if ExperimentalFeatures.shared.showTouches.isEnabled
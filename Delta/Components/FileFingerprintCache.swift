@@ -0,0 +1,168 @@
+//
+//  FileFingerprintCache.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Caches SHA-1 hashes of files keyed by their (device, inode, size, modification date) fingerprint,
+// so unchanged files (e.g. game saves) don't need to be fully rehashed every time we check them.
+final class FileFingerprintCache
+{
+    static let shared = FileFingerprintCache(fileURL: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appendingPathComponent("FileFingerprints.plist"))
+    
+    let fileURL: URL
+    
+    // Number of lookups that returned a cached hash.
+    var hitCount: Int {
+        return self.lock.withLock { self._hitCount }
+    }
+    private var _hitCount = 0
+    
+    // Number of lookups that required (re)hashing the file.
+    var missCount: Int {
+        return self.lock.withLock { self._missCount }
+    }
+    private var _missCount = 0
+    
+    private var entriesByPath: [String: Entry]
+    private var isSaveScheduled = false
+    
+    private let lock = NSLock()
+    private let saveQueue = DispatchQueue(label: "com.rileytestut.Delta.FileFingerprintCache", qos: .utility)
+    
+    init(fileURL: URL)
+    {
+        self.fileURL = fileURL
+        
+        do
+        {
+            let data = try Data(contentsOf: fileURL)
+            self.entriesByPath = try PropertyListDecoder().decode([String: Entry].self, from: data)
+        }
+        catch
+        {
+            // Missing or corrupted cache just means we need to rehash files.
+            self.entriesByPath = [:]
+        }
+    }
+}
+
+private extension FileFingerprintCache
+{
+    struct Fingerprint: Codable, Equatable
+    {
+        var device: UInt64
+        var inode: UInt64
+        var size: Int64
+        
+        // Nanosecond precision so saves written multiple times per second are still detected.
+        var modificationTime: Int64
+    }
+    
+    struct Entry: Codable
+    {
+        var fingerprint: Fingerprint
+        var sha1Hash: String
+    }
+}
+
+extension FileFingerprintCache
+{
+    func sha1Hash(ofItemAt fileURL: URL) throws -> String
+    {
+        let path = fileURL.standardizedFileURL.path
+        
+        // Fingerprint _before_ hashing so any changes made while hashing will invalidate cached hash next time.
+        let fingerprint = try self.fingerprint(ofItemAtPath: path)
+        
+        self.lock.lock()
+        
+        if let entry = self.entriesByPath[path], entry.fingerprint == fingerprint
+        {
+            self._hitCount += 1
+            self.lock.unlock()
+            
+            return entry.sha1Hash
+        }
+        
+        self._missCount += 1
+        self.lock.unlock()
+        
+        let sha1Hash = try FileManager.default.sha1Hash(ofItemAt: fileURL)
+        
+        self.lock.lock()
+        self.entriesByPath[path] = Entry(fingerprint: fingerprint, sha1Hash: sha1Hash)
+        self.lock.unlock()
+        
+        self.scheduleSave()
+        
+        return sha1Hash
+    }
+}
+
+private extension FileFingerprintCache
+{
+    func fingerprint(ofItemAtPath path: String) throws -> Fingerprint
+    {
+        var fileInfo = stat()
+        guard stat(path, &fileInfo) == 0 else {
+            let code = POSIXErrorCode(rawValue: errno) ?? .EIO
+            if code == .ENOENT
+            {
+                // Match FileManager's error so callers can continue catching CocoaError.fileNoSuchFile.
+                throw CocoaError(.fileNoSuchFile, userInfo: [NSFilePathErrorKey: path])
+            }
+            
+            throw POSIXError(code)
+        }
+        
+        let modificationTime = Int64(fileInfo.st_mtimespec.tv_sec) * 1_000_000_000 + Int64(fileInfo.st_mtimespec.tv_nsec)
+        
+        let fingerprint = Fingerprint(device: UInt64(bitPattern: Int64(fileInfo.st_dev)), inode: UInt64(fileInfo.st_ino), size: Int64(fileInfo.st_size), modificationTime: modificationTime)
+        return fingerprint
+    }
+    
+    func scheduleSave()
+    {
+        // Lookups happen on the emulation path (e.g. whenever a game saves), so coalesce writes and perform them off the caller's thread.
+        let shouldSchedule = self.lock.withLock {
+            guard !self.isSaveScheduled else { return false }
+            self.isSaveScheduled = true
+            return true
+        }
+        
+        guard shouldSchedule else { return }
+        
+        self.saveQueue.asyncAfter(deadline: .now() + 2.0) {
+            self.save()
+        }
+    }
+    
+    func save()
+    {
+        let (entriesByPath, hitCount, missCount) = self.lock.withLock {
+            self.isSaveScheduled = false
+            return (self.entriesByPath, self._hitCount, self._missCount)
+        }
+        
+        // Saves are coalesced, so this logs at most once every couple seconds while files are being checked.
+        Logger.main.info("Saving file fingerprint cache (\(entriesByPath.count) file(s)). \(hitCount) hit(s), \(missCount) miss(es).")
+        
+        do
+        {
+            let encoder = PropertyListEncoder()
+            encoder.outputFormat = .binary
+            
+            let data = try encoder.encode(entriesByPath)
+            try data.write(to: self.fileURL, options: .atomic)
+        }
+        catch
+        {
+            Logger.main.error("Failed to save file fingerprint cache. \(error.localizedDescription, privacy: .public)")
+        }
+    }
+}
@@ -0,0 +1,205 @@
+//
+//  LRUCache.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Thread-safe in-memory cache that charges each value a cost (e.g. decoded image size in bytes),
+// and evicts least recently used values once total cost exceeds costLimit.
+//
+// Unlike NSCache, eviction order is deterministic and hit/miss/eviction counts are tracked.
+final class LRUCache<Key: Hashable, Value>
+{
+    struct Statistics
+    {
+        var count = 0
+        var totalCost = 0
+        
+        var hitCount = 0
+        var missCount = 0
+        var evictionCount = 0
+    }
+    
+    var costLimit: Int {
+        get { self.lock.withLock { self._costLimit } }
+        set {
+            self.lock.withLock {
+                self._costLimit = newValue
+                self.evictIfNeeded()
+            }
+        }
+    }
+    private var _costLimit: Int
+    
+    var statistics: Statistics {
+        return self.lock.withLock { self._statistics }
+    }
+    private var _statistics = Statistics()
+    
+    private var nodesByKey = [Key: Node]()
+    
+    // Most recently used node is head, least recently used is tail.
+    private var head: Node?
+    private var tail: Node?
+    
+    private let lock = NSLock()
+    
+    init(costLimit: Int)
+    {
+        self._costLimit = costLimit
+    }
+}
+
+extension LRUCache
+{
+    func value(forKey key: Key) -> Value?
+    {
+        return self.lock.withLock {
+            guard let node = self.nodesByKey[key] else {
+                self._statistics.missCount += 1
+                return nil
+            }
+            
+            self._statistics.hitCount += 1
+            
+            self.remove(node)
+            self.insertAtHead(node)
+            
+            return node.value
+        }
+    }
+    
+    func setValue(_ value: Value, forKey key: Key, cost: Int)
+    {
+        self.lock.withLock {
+            if let node = self.nodesByKey[key]
+            {
+                self.remove(node)
+                self.nodesByKey[key] = nil
+            }
+            
+            // Never cache values that would evict everything else.
+            guard cost <= self._costLimit else { return }
+            
+            let node = Node(key: key, value: value, cost: cost)
+            self.insertAtHead(node)
+            self.nodesByKey[key] = node
+            
+            self.evictIfNeeded()
+        }
+    }
+    
+    func removeValue(forKey key: Key)
+    {
+        self.lock.withLock {
+            guard let node = self.nodesByKey[key] else { return }
+            
+            self.remove(node)
+            self.nodesByKey[key] = nil
+        }
+    }
+    
+    func removeAllValues()
+    {
+        self.lock.withLock {
+            self.nodesByKey.removeAll()
+            
+            // Break links so nodes are deallocated.
+            var node = self.head
+            while let currentNode = node
+            {
+                node = currentNode.next
+                currentNode.next = nil
+                currentNode.previous = nil
+            }
+            
+            self.head = nil
+            self.tail = nil
+            
+            self._statistics.count = 0
+            self._statistics.totalCost = 0
+        }
+    }
+}
+
+private extension LRUCache
+{
+    final class Node
+    {
+        let key: Key
+        let value: Value
+        let cost: Int
+        
+        weak var previous: Node?
+        var next: Node?
+        
+        init(key: Key, value: Value, cost: Int)
+        {
+            self.key = key
+            self.value = value
+            self.cost = cost
+        }
+    }
+    
+    // Must be called while holding lock.
+    func insertAtHead(_ node: Node)
+    {
+        node.previous = nil
+        node.next = self.head
+        
+        self.head?.previous = node
+        self.head = node
+        
+        if self.tail == nil
+        {
+            self.tail = node
+        }
+        
+        self._statistics.count += 1
+        self._statistics.totalCost += node.cost
+    }
+    
+    // Must be called while holding lock.
+    func remove(_ node: Node)
+    {
+        if let previous = node.previous
+        {
+            previous.next = node.next
+        }
+        else
+        {
+            self.head = node.next
+        }
+        
+        if let next = node.next
+        {
+            next.previous = node.previous
+        }
+        else
+        {
+            self.tail = node.previous
+        }
+        
+        node.previous = nil
+        node.next = nil
+        
+        self._statistics.count -= 1
+        self._statistics.totalCost -= node.cost
+    }
+    
+    // Must be called while holding lock.
+    func evictIfNeeded()
+    {
+        while self._statistics.totalCost > self._costLimit, let node = self.tail
+        {
+            self.remove(node)
+            self.nodesByKey[node.key] = nil
+            
+            self._statistics.evictionCount += 1
+        }
+    }
+}
@@ -27,15 +27,19 @@ class LoadImageURLOperation: RSTLoadOperation<UIImage, NSURL>, @unchecked Sendab
 {
     let url: URL
     
+    // If non-nil, image is decoded at (at most) this size and cached by ThumbnailCache.
+    let maximumPixelSize: CGFloat?
+    
     override var isAsynchronous: Bool {
         return !self.url.isFileURL
     }
     
     private var downloadOperation: SDWebImageOperation?
     
-    init(url: URL)
+    init(url: URL, maximumPixelSize: CGFloat? = nil)
     {
         self.url = url
+        self.maximumPixelSize = maximumPixelSize
         
         super.init(cacheKey: url as NSURL)
     }
@@ -56,12 +60,20 @@ class LoadImageURLOperation: RSTLoadOperation<UIImage, NSURL>, @unchecked Sendab
     {
         let callback = { (image: UIImage?, error: Error?) in
             
-            if let image = image, !self.isCancelled
+            guard var image = image, !self.isCancelled else { return completion(image, error) }
+            
+            if let maximumPixelSize = self.maximumPixelSize
+            {
+                // Local thumbnails are already decoded, so this only downscales remote images.
+                if !self.url.isFileURL
+                {
+                    image = ThumbnailCache.shared.thumbnail(for: image, url: self.url, maximumPixelSize: maximumPixelSize)
+                }
+            }
+            else
             {
                 // Force decompression of image
-                UIGraphicsBeginImageContextWithOptions(CGSize(width: 1, height: 1), true, 1.0)
-                image.draw(at: CGPoint.zero)
-                UIGraphicsEndImageContext()
+                image = image.preparingForDisplay() ?? image
             }
             
             completion(image, error)
@@ -79,6 +91,15 @@ class LoadImageURLOperation: RSTLoadOperation<UIImage, NSURL>, @unchecked Sendab
     
     private func loadLocalImage(completion: @escaping (UIImage?, Error?) -> Void)
     {
+        if let maximumPixelSize = self.maximumPixelSize
+        {
+            guard FileManager.default.fileExists(atPath: self.url.path) else { return completion(nil, .doesNotExist) }
+            
+            // Decode directly at thumbnail size, rather than decoding full image then scaling it down.
+            guard let thumbnail = ThumbnailCache.shared.thumbnail(forImageAt: self.url, maximumPixelSize: maximumPixelSize) else { return completion(nil, .invalid) }
+            return completion(thumbnail, nil)
+        }
+        
         guard let imageSource = CGImageSourceCreateWithURL(self.url as CFURL, nil) else {
             completion(nil, .doesNotExist)
             return
@@ -95,6 +116,11 @@ class LoadImageURLOperation: RSTLoadOperation<UIImage, NSURL>, @unchecked Sendab
     
     private func loadRemoteImage(completion: @escaping (UIImage?, Error?) -> Void)
     {
+        if let maximumPixelSize = self.maximumPixelSize, let thumbnail = ThumbnailCache.shared.cachedThumbnail(forImageAt: self.url, maximumPixelSize: maximumPixelSize)
+        {
+            return completion(thumbnail, nil)
+        }
+        
         let manager = SDWebImageManager.shared()
         
         self.downloadOperation = manager?.downloadImage(with: self.url, options: [.retryFailed, .continueInBackground], progress: nil, completed: { (image, error, cacheType, finished, imageURL) in
@@ -0,0 +1,50 @@
+//
+//  LoadSaveStateThumbnailOperation.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import UIKit
+
+// Prefers thumbnail embedded in save state container, falling back to decoding full-size snapshot at imageFileURL.
+class LoadSaveStateThumbnailOperation: LoadImageURLOperation, @unchecked Sendable
+{
+    let saveStateFileURL: URL
+    
+    init(saveState: SaveState, maximumPixelSize: CGFloat)
+    {
+        self.saveStateFileURL = saveState.fileURL
+        
+        super.init(url: saveState.imageFileURL, maximumPixelSize: maximumPixelSize)
+    }
+    
+    override func loadResult(completion: @escaping (UIImage?, Swift.Error?) -> Void)
+    {
+        if let thumbnail = self.embeddedThumbnail()
+        {
+            completion(thumbnail, nil)
+        }
+        else
+        {
+            super.loadResult(completion: completion)
+        }
+    }
+}
+
+private extension LoadSaveStateThumbnailOperation
+{
+    func embeddedThumbnail() -> UIImage?
+    {
+        guard let maximumPixelSize = self.maximumPixelSize, SaveStateContainer.isContainer(at: self.saveStateFileURL) else { return nil }
+        
+        guard let container = try? SaveStateContainer(fileURL: self.saveStateFileURL), let thumbnail = container.thumbnail else { return nil }
+        
+        // Embedded thumbnails are small, so only use them if they won't look blurry.
+        let pixelSize = max(thumbnail.size.width, thumbnail.size.height) * thumbnail.scale
+        guard pixelSize >= maximumPixelSize else { return nil }
+        
+        return thumbnail.preparingForDisplay() ?? thumbnail
+    }
+}
@@ -0,0 +1,383 @@
+//
+//  ThumbnailCache.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import UIKit
+import ImageIO
+import UniformTypeIdentifiers
+import CryptoKit
+
+// Decodes images directly at the size they're displayed, then caches the decoded thumbnails in memory + on disk.
+//
+// Full-size artwork and save state snapshots are never decoded into memory, so memory use depends only on
+// how many cells are visible rather than the size (or number) of source images.
+//
+// Both caches are bounded: the memory cache charges each thumbnail its decoded size in bytes and evicts least recently used thumbnails
+// once memoryLimit is exceeded, and the disk cache removes least recently used files as new ones are written once diskLimit is exceeded.
+final class ThumbnailCache
+{
+    struct Statistics
+    {
+        var memory = LRUCache<String, UIImage>.Statistics()
+        var disk = DiskStatistics()
+        
+        // Number of thumbnails decoded from source images (rather than loaded from cache).
+        var decodeCount = 0
+    }
+    
+    struct DiskStatistics
+    {
+        var count = 0
+        var totalSize: Int64 = 0
+        
+        var hitCount = 0
+        var missCount = 0
+        var evictionCount = 0
+    }
+    
+    static let shared = ThumbnailCache(directoryURL: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appendingPathComponent("Thumbnails", isDirectory: true))
+    
+    let directoryURL: URL
+    
+    // Maximum total size of decoded thumbnails kept in memory, in bytes.
+    var memoryLimit: Int {
+        get { self.memoryCache.costLimit }
+        set { self.memoryCache.costLimit = newValue }
+    }
+    
+    // Maximum total size of thumbnails on disk, in bytes.
+    var diskLimit: Int64 {
+        get { self.diskLock.withLock { self._diskLimit } }
+        set {
+            self.diskLock.withLock {
+                self._diskLimit = newValue
+                self.pruneDiskCacheIfNeeded()
+            }
+        }
+    }
+    private var _diskLimit: Int64
+    
+    var statistics: Statistics {
+        var statistics = Statistics()
+        statistics.memory = self.memoryCache.statistics
+        
+        self.diskLock.withLock {
+            statistics.disk = self.diskStatistics
+            statistics.decodeCount = self.decodeCount
+        }
+        
+        return statistics
+    }
+    
+    private let memoryCache: LRUCache<String, UIImage>
+    
+    // Loaded lazily the first time we access disk cache, so we don't enumerate every cached thumbnail on launch.
+    private var diskEntries: [String: DiskEntry]?
+    private var diskStatistics = DiskStatistics()
+    private var decodeCount = 0
+    
+    private let diskLock = NSLock()
+    
+    init(directoryURL: URL, memoryLimit: Int = 48 * 1024 * 1024, diskLimit: Int64 = 128 * 1024 * 1024)
+    {
+        self.directoryURL = directoryURL
+        self.memoryCache = LRUCache(costLimit: memoryLimit)
+        self._diskLimit = diskLimit
+        
+        do
+        {
+            try FileManager.default.createDirectory(at: directoryURL, withIntermediateDirectories: true)
+        }
+        catch
+        {
+            Logger.main.error("Failed to create thumbnail cache directory. \(error.localizedDescription, privacy: .public)")
+        }
+        
+        NotificationCenter.default.addObserver(forName: UIApplication.didReceiveMemoryWarningNotification, object: nil, queue: nil) { [weak self] _ in
+            guard let self else { return }
+            
+            let statistics = self.statistics
+            Logger.main.info("Purging thumbnail memory cache (\(statistics.memory.totalCost) bytes). Memory: \(statistics.memory.hitCount) hit(s), \(statistics.memory.missCount) miss(es), \(statistics.memory.evictionCount) eviction(s). Disk: \(statistics.disk.hitCount) hit(s), \(statistics.disk.missCount) miss(es), \(statistics.disk.evictionCount) eviction(s), \(statistics.disk.totalSize) bytes.")
+            
+            self.memoryCache.removeAllValues()
+        }
+    }
+}
+
+extension ThumbnailCache
+{
+    /// Returns thumbnail for image at `url` (local or remote) if it's already cached, without loading source image.
+    ///
+    /// Cheap enough to call on the main thread (at worst it decodes a small thumbnail from disk).
+    func cachedThumbnail(forImageAt url: URL, maximumPixelSize: CGFloat) -> UIImage?
+    {
+        guard let key = self.key(forImageAt: url, maximumPixelSize: maximumPixelSize) else { return nil }
+        return self.cachedThumbnail(forKey: key)
+    }
+    
+    /// Returns thumbnail for image at `fileURL` whose longest side is at most `maximumPixelSize` pixels, decoding + caching it if necessary.
+    func thumbnail(forImageAt fileURL: URL, maximumPixelSize: CGFloat) -> UIImage?
+    {
+        guard let key = self.key(forImageAt: fileURL, maximumPixelSize: maximumPixelSize) else { return nil }
+        
+        if let thumbnail = self.cachedThumbnail(forKey: key)
+        {
+            return thumbnail
+        }
+        
+        guard let imageSource = CGImageSourceCreateWithURL(fileURL as CFURL, [kCGImageSourceShouldCache: false] as CFDictionary) else { return nil }
+        
+        let options: [CFString: Any] = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceThumbnailMaxPixelSize: Int(maximumPixelSize.rounded(.up)),
+            kCGImageSourceShouldCacheImmediately: true // Decode now rather than on main thread when first drawn.
+        ]
+        
+        guard let cgImage = CGImageSourceCreateThumbnailAtIndex(imageSource, 0, options as CFDictionary) else { return nil }
+        self.diskLock.withLock { self.decodeCount += 1 }
+        
+        let thumbnail = UIImage(cgImage: cgImage)
+        self.insert(thumbnail, forKey: key)
+        
+        return thumbnail
+    }
+    
+    /// Returns downscaled copy of already-loaded `image` (e.g. remote artwork), caching it under `url`.
+    func thumbnail(for image: UIImage, url: URL, maximumPixelSize: CGFloat) -> UIImage
+    {
+        guard let key = self.key(forImageAt: url, maximumPixelSize: maximumPixelSize) else { return image }
+        
+        if let thumbnail = self.cachedThumbnail(forKey: key)
+        {
+            return thumbnail
+        }
+        
+        let pixelSize = CGSize(width: image.size.width * image.scale, height: image.size.height * image.scale)
+        let scale = min(maximumPixelSize / max(pixelSize.width, pixelSize.height), 1.0)
+        
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1.0
+        format.opaque = image.cgImage.map(ThumbnailCache.isOpaque(_:)) ?? false
+        
+        let size = CGSize(width: (pixelSize.width * scale).rounded(), height: (pixelSize.height * scale).rounded())
+        let renderer = UIGraphicsImageRenderer(size: size, format: format)
+        
+        let thumbnail = renderer.image { _ in
+            image.draw(in: CGRect(origin: .zero, size: size))
+        }
+        self.diskLock.withLock { self.decodeCount += 1 }
+        
+        self.insert(thumbnail, forKey: key)
+        return thumbnail
+    }
+    
+    func removeAllThumbnails()
+    {
+        self.memoryCache.removeAllValues()
+        
+        self.diskLock.withLock {
+            do
+            {
+                try FileManager.default.removeItem(at: self.directoryURL)
+                try FileManager.default.createDirectory(at: self.directoryURL, withIntermediateDirectories: true)
+            }
+            catch
+            {
+                Logger.main.error("Failed to remove cached thumbnails. \(error.localizedDescription, privacy: .public)")
+            }
+            
+            self.diskEntries = [:]
+            self.diskStatistics.count = 0
+            self.diskStatistics.totalSize = 0
+        }
+    }
+}
+
+private extension ThumbnailCache
+{
+    static func key(for identifier: String, maximumPixelSize: CGFloat) -> String
+    {
+        let key = SHA256.hash(data: Data("\(identifier)@\(Int(maximumPixelSize.rounded(.up)))".utf8)).hexString
+        return key
+    }
+    
+    func key(forImageAt url: URL, maximumPixelSize: CGFloat) -> String?
+    {
+        guard url.isFileURL else { return ThumbnailCache.key(for: url.absoluteString, maximumPixelSize: maximumPixelSize) }
+        
+        let fileURL = url
+        
+        // Include modification date so replacing image (e.g. updating save state) invalidates its thumbnails.
+        guard let modificationDate = try? fileURL.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate else { return nil }
+        
+        let key = ThumbnailCache.key(for: "\(fileURL.path)#\(modificationDate.timeIntervalSinceReferenceDate)", maximumPixelSize: maximumPixelSize)
+        return key
+    }
+    
+    struct DiskEntry
+    {
+        var size: Int64
+        var accessDate: Date
+    }
+    
+    func cachedThumbnail(forKey key: String) -> UIImage?
+    {
+        if let thumbnail = self.memoryCache.value(forKey: key)
+        {
+            return thumbnail
+        }
+        
+        let isCachedOnDisk = self.diskLock.withLock {
+            self.loadDiskEntriesIfNeeded()
+            
+            guard self.diskEntries?[key] != nil else {
+                self.diskStatistics.missCount += 1
+                return false
+            }
+            
+            self.diskEntries?[key]?.accessDate = Date()
+            self.diskStatistics.hitCount += 1
+            return true
+        }
+        
+        guard isCachedOnDisk else { return nil }
+        
+        let fileURL = self.directoryURL.appendingPathComponent(key)
+        
+        guard
+            let imageSource = CGImageSourceCreateWithURL(fileURL as CFURL, nil),
+            let cgImage = CGImageSourceCreateImageAtIndex(imageSource, 0, [kCGImageSourceShouldCacheImmediately: true] as CFDictionary)
+        else {
+            // File was removed or corrupted, so forget about it.
+            self.diskLock.withLock { self.removeDiskEntry(forKey: key) }
+            return nil
+        }
+        
+        // Persist access order so disk cache is still pruned in LRU order after relaunching.
+        try? FileManager.default.setAttributes([.modificationDate: Date()], ofItemAtPath: fileURL.path)
+        
+        let thumbnail = UIImage(cgImage: cgImage)
+        self.memoryCache.setValue(thumbnail, forKey: key, cost: ThumbnailCache.cost(of: thumbnail))
+        
+        return thumbnail
+    }
+    
+    func insert(_ thumbnail: UIImage, forKey key: String)
+    {
+        self.memoryCache.setValue(thumbnail, forKey: key, cost: ThumbnailCache.cost(of: thumbnail))
+        
+        guard let cgImage = thumbnail.cgImage else { return }
+        
+        // Thumbnails are small, so JPEG is plenty for opaque images and much smaller than PNG.
+        let type = ThumbnailCache.isOpaque(cgImage) ? UTType.jpeg : UTType.png
+        
+        // Write to hidden file first so other threads never read partially written thumbnails.
+        let temporaryURL = self.directoryURL.appendingPathComponent("." + UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: temporaryURL) }
+        
+        guard let destination = CGImageDestinationCreateWithURL(temporaryURL as CFURL, type.identifier as CFString, 1, nil) else { return }
+        CGImageDestinationAddImage(destination, cgImage, [kCGImageDestinationLossyCompressionQuality: 0.9] as CFDictionary)
+        
+        do
+        {
+            guard CGImageDestinationFinalize(destination) else { throw CocoaError(.fileWriteUnknown) }
+            
+            let fileURL = self.directoryURL.appendingPathComponent(key)
+            _ = try FileManager.default.replaceItemAt(fileURL, withItemAt: temporaryURL)
+            
+            let size = try fileURL.resourceValues(forKeys: [.totalFileAllocatedSizeKey]).totalFileAllocatedSize ?? 0
+            
+            self.diskLock.withLock {
+                self.loadDiskEntriesIfNeeded()
+                self.removeDiskEntry(forKey: key, removingFile: false)
+                
+                self.diskEntries?[key] = DiskEntry(size: Int64(size), accessDate: Date())
+                self.diskStatistics.count += 1
+                self.diskStatistics.totalSize += Int64(size)
+                
+                self.pruneDiskCacheIfNeeded()
+            }
+        }
+        catch
+        {
+            Logger.main.error("Failed to cache thumbnail \(key, privacy: .public). \(error.localizedDescription, privacy: .public)")
+        }
+    }
+    
+    // Must be called while holding diskLock.
+    func loadDiskEntriesIfNeeded()
+    {
+        guard self.diskEntries == nil else { return }
+        
+        let resourceKeys: Set<URLResourceKey> = [.totalFileAllocatedSizeKey, .contentModificationDateKey]
+        let fileURLs = (try? FileManager.default.contentsOfDirectory(at: self.directoryURL, includingPropertiesForKeys: Array(resourceKeys), options: .skipsHiddenFiles)) ?? []
+        
+        var diskEntries = [String: DiskEntry]()
+        var totalSize: Int64 = 0
+        
+        for fileURL in fileURLs
+        {
+            guard let resourceValues = try? fileURL.resourceValues(forKeys: resourceKeys) else { continue }
+            
+            let entry = DiskEntry(size: Int64(resourceValues.totalFileAllocatedSize ?? 0), accessDate: resourceValues.contentModificationDate ?? .distantPast)
+            diskEntries[fileURL.lastPathComponent] = entry
+            
+            totalSize += entry.size
+        }
+        
+        self.diskEntries = diskEntries
+        self.diskStatistics.count = diskEntries.count
+        self.diskStatistics.totalSize = totalSize
+    }
+    
+    // Must be called while holding diskLock.
+    func removeDiskEntry(forKey key: String, removingFile: Bool = true)
+    {
+        guard let entry = self.diskEntries?.removeValue(forKey: key) else { return }
+        
+        self.diskStatistics.count -= 1
+        self.diskStatistics.totalSize -= entry.size
+        
+        if removingFile
+        {
+            try? FileManager.default.removeItem(at: self.directoryURL.appendingPathComponent(key))
+        }
+    }
+    
+    // Must be called while holding diskLock.
+    func pruneDiskCacheIfNeeded()
+    {
+        guard let diskEntries = self.diskEntries, self.diskStatistics.totalSize > self._diskLimit else { return }
+        
+        // Prune down to 75% of limit so we don't need to prune again for every new thumbnail.
+        let targetSize = self._diskLimit / 4 * 3
+        
+        for (key, _) in diskEntries.sorted(by: { $0.value.accessDate < $1.value.accessDate })
+        {
+            guard self.diskStatistics.totalSize > targetSize else { break }
+            
+            self.removeDiskEntry(forKey: key)
+            self.diskStatistics.evictionCount += 1
+        }
+    }
+    
+    static func isOpaque(_ cgImage: CGImage) -> Bool
+    {
+        switch cgImage.alphaInfo
+        {
+        case .none, .noneSkipFirst, .noneSkipLast: return true
+        default: return false
+        }
+    }
+    
+    static func cost(of image: UIImage) -> Int
+    {
+        guard let cgImage = image.cgImage else { return 0 }
+        return cgImage.bytesPerRow * cgImage.height
+    }
+}
@@ -10,6 +10,7 @@ import Foundation
 import SQLite
 
 import Roxas
+import ZIPFoundation
 
 // Prefer SQLite's Expression over iOS 18's new Foundation.Expression
 private typealias Expression = SQLite.Expression
@@ -70,6 +71,36 @@ extension Table
     }
 }
 
+// Decodes cheats(for:) rows by column index (in the order they're selected),
+// rather than resolving every column by name for every row.
+private struct CheatRow
+{
+    var cheatID: Int
+    var cheatName: String
+    var cheatCode: String
+    var cheatDescription: String?
+    var cheatActivation: String?
+    var cheatDeviceID: Int
+    
+    var categoryID: Int
+    var categoryName: String
+    var categoryDescription: String
+    
+    init(_ cursor: Cursor)
+    {
+        self.cheatID = cursor[0]
+        self.cheatName = cursor[1]
+        self.cheatCode = cursor[2]
+        self.cheatDescription = cursor[3] as Binding? as? String
+        self.cheatActivation = cursor[4] as Binding? as? String
+        self.cheatDeviceID = cursor[5]
+        
+        self.categoryID = cursor[6]
+        self.categoryName = cursor[7]
+        self.categoryDescription = cursor[8]
+    }
+}
+
 @available(iOS 14, *)
 class CheatBase: GamesDatabase
 {
@@ -78,7 +109,20 @@ class CheatBase: GamesDatabase
         return UserDefaults.standard.previousCheatBaseVersion
     }
     
+    // Serializes installing + opening CheatBase, which is done lazily the first time cheats are requested.
+    private static let installQueue = DispatchQueue(label: "com.rileytestut.Delta.CheatBase.install", qos: .userInitiated)
+    private static var sharedDatabase: CheatBase?
+    
+    // Only used to build the romID index. Cheats are queried through readerPool.
     private let connection: Connection
+    private let readerPool: ReadOnlyConnectionPool
+    
+    // Only keep a few games' worth of cheats around, since they're typically requested for the game currently being played.
+    private let cheatsCache: NSCache<NSNumber, Box<[CheatMetadata]>> = {
+        let cache = NSCache<NSNumber, Box<[CheatMetadata]>>()
+        cache.countLimit = 8
+        return cache
+    }()
     
     override init() throws
     {
@@ -87,11 +131,45 @@ class CheatBase: GamesDatabase
         
         self.connection = try Connection(fileURL.path)
         
+        // Readers are opened lazily, so they'll never be opened before prepareCheatsIndex() finishes below.
+        // CheatBase is never modified after that, so they can safely skip file locking.
+        self.readerPool = ReadOnlyConnectionPool(fileURL: fileURL, isImmutable: true)
+        
         try super.init()
         
+        self.prepareCheatsIndex()
+        
         UserDefaults.standard.previousCheatBaseVersion = CheatBase.cheatsVersion
     }
     
+    // Installs CheatBase in the background if needed, then returns shared instance.
+    static func database() async throws -> CheatBase
+    {
+        try await withCheckedThrowingContinuation { continuation in
+            CheatBase.installQueue.async {
+                do
+                {
+                    if let database = CheatBase.sharedDatabase
+                    {
+                        continuation.resume(returning: database)
+                        return
+                    }
+                    
+                    try CheatBase.installIfNeeded()
+                    
+                    let database = try CheatBase()
+                    CheatBase.sharedDatabase = database
+                    
+                    continuation.resume(returning: database)
+                }
+                catch
+                {
+                    continuation.resume(throwing: error)
+                }
+            }
+        }
+    }
+    
     func cheats(for game: Game) async throws -> [CheatMetadata]?
     {
         let metadata = await withCheckedContinuation { continuation in
@@ -111,6 +189,11 @@ class CheatBase: GamesDatabase
         
         guard let romIDValue = metadata?.romID else { return nil }
         
+        if let cachedCheats = self.cheatsCache.object(forKey: romIDValue as NSNumber)
+        {
+            return cachedCheats.value
+        }
+        
         let cheatID = Expression<Any>.cheatID
         let cheatName = Expression<Any>.cheatName
         let cheatCode = Expression<Any>.cheatCode
@@ -129,18 +212,70 @@ class CheatBase: GamesDatabase
             .join(Table.cheatCategories, on: Table.cheats[categoryID] == Table.cheatCategories[categoryID])
             .order(cheatName)
         
-        let rows = try self.connection.prepare(query)
-        
-        let results = rows.compactMap { (row) -> CheatMetadata? in
-            guard case let deviceID = Int16(row[cheatDeviceID]), let device = CheatDevice(rawValue: deviceID) else { return nil }
-            
-            let id = row[Table.cheats[categoryID]]
-            
-            let category = CheatCategory(id: id, name: row[categoryName], categoryDescription: row[categoryDescription])
-            let metadata = CheatMetadata(id: row[cheatID], name: row[cheatName], code: row[cheatCode], description: row[cheatDescription], activationHint: row[cheatActivation], device: device, category: category)
-            return metadata
+        let expression = query.expression
+        let results = try self.readerPool.withReader { (reader) -> [CheatMetadata] in
+            try reader.statementCache.withStatement(expression.template, expression.bindings) { (statement) -> [CheatMetadata] in
+                var results = [CheatMetadata]()
+                
+                while try statement.step()
+                {
+                    let row = CheatRow(statement.row)
+                    guard case let deviceID = Int16(row.cheatDeviceID), let device = CheatDevice(rawValue: deviceID) else { continue }
+                    
+                    let category = CheatCategory(id: row.categoryID, name: row.categoryName, categoryDescription: row.categoryDescription)
+                    let metadata = CheatMetadata(id: row.cheatID, name: row.cheatName, code: row.cheatCode, description: row.cheatDescription, activationHint: row.cheatActivation, device: device, category: category)
+                    results.append(metadata)
+                }
+                
+                return results
+            }
         }
         
+        self.cheatsCache.setObject(Box(results), forKey: romIDValue as NSNumber)
+        
         return results
     }
 }
+
+@available(iOS 14, *)
+private extension CheatBase
+{
+    static func installIfNeeded() throws
+    {
+        let databaseURL = DatabaseManager.cheatBaseURL
+        guard !FileManager.default.fileExists(atPath: databaseURL.path) || CheatBase.cheatsVersion != CheatBase.previousCheatsVersion else { return }
+        
+        guard let archiveURL = Bundle.main.url(forResource: "cheatbase", withExtension: "zip") else { throw GamesDatabase.Error.doesNotExist }
+        
+        let archive = try Archive(url: archiveURL, accessMode: .read)
+        guard let entry = archive["cheatbase.sqlite"] else { throw GamesDatabase.Error.doesNotExist }
+        
+        // Extract just the database (e.g. no __MACOSX directory) next to its final location, then replace any previous version.
+        let temporaryURL = databaseURL.deletingLastPathComponent().appendingPathComponent("." + UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: temporaryURL) }
+        
+        _ = try archive.extract(entry, to: temporaryURL, skipCRC32: true) // skipCRC32 to avoid ~10 second extraction.
+        
+        if FileManager.default.fileExists(atPath: databaseURL.path)
+        {
+            try FileManager.default.removeItem(at: databaseURL)
+        }
+        
+        try FileManager.default.moveItem(at: temporaryURL, to: databaseURL)
+    }
+    
+    func prepareCheatsIndex()
+    {
+        // CHEATS has no index on romID, so build one once so looking up a game's cheats doesn't scan the entire table.
+        let romID = Expression<Any>.romID
+        
+        do
+        {
+            try self.connection.run(Table.cheats.createIndex(romID, ifNotExists: true))
+        }
+        catch
+        {
+            print(error)
+        }
+    }
+}
@@ -51,7 +51,7 @@ extension CheatBaseView
             
             do
             {
-                let database = try CheatBase()                
+                let database = try await CheatBase.database()
                 let cheats = try await database.cheats(for: game) ?? []
                 self.allCheats = cheats
             }
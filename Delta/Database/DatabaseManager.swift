@@ -51,6 +51,9 @@ final class DatabaseManager: RSTPersistentContainer, @unchecked Sendable
     private(set) var isStarted = false
     
     private var gamesDatabase: GamesDatabase? = nil
+    private let gameChecksumIndex = GameChecksumIndex(fileURL: DatabaseManager.gameChecksumIndexURL)
+    
+    let saveStateBlobStore = SaveStateBlobStore(directoryURL: DatabaseManager.saveStateBlobsDirectoryURL)
     
     private var validationManagedObjectContext: NSManagedObjectContext?
     
@@ -304,39 +307,44 @@ private extension DatabaseManager
                     try FileManager.default.copyItem(at: bundleURL, to: DatabaseManager.gamesDatabaseURL, shouldReplace: true)
                 }
                 
+                // CheatBase is installed lazily the first time cheats are requested (see CheatBase.database()).
                 self.gamesDatabase = try GamesDatabase()
-                
-                if #available(iOS 14, *), !FileManager.default.fileExists(atPath: DatabaseManager.cheatBaseURL.path) || CheatBase.cheatsVersion != CheatBase.previousCheatsVersion
-                {
-                    guard let archiveURL = Bundle.main.url(forResource: "cheatbase", withExtension: "zip") else { throw GamesDatabase.Error.doesNotExist }
-                    
-                    let temporaryDirectoryURL = FileManager.default.uniqueTemporaryURL()
-                    try FileManager.default.createDirectory(at: temporaryDirectoryURL, withIntermediateDirectories: true)
-                    defer {
-                        try? FileManager.default.removeItem(at: temporaryDirectoryURL)
-                    }
-                    
-                    // Unzip to temporaryDirectoryURL first to ensure we don't accidentally unzip other items into DatabaseManager.cheatBaseURL directory (e.g. __MACOSX directory).
-                    try FileManager.default.unzipItem(at: archiveURL, to: temporaryDirectoryURL, skipCRC32: true) // skipCRC32 to avoid ~10 second extraction.
-                    
-                    let extractedDatabaseURL = temporaryDirectoryURL.appendingPathComponent("cheatbase.sqlite")
-                    try FileManager.default.copyItem(at: extractedDatabaseURL, to: DatabaseManager.cheatBaseURL, shouldReplace: true)
-                    
-                    // Cache CheatBase.previousCheatsVersion
-                    _ = try CheatBase()
-                }                
+                self.gamesDatabase?.prepareSearchIndexIfNeeded()
             }
             catch
             {
                 print(error)
             }
             
+            // Clean up blobs orphaned by save states replaced or deleted outside SaveStateBlobStore (e.g. by syncing).
+            let statistics = self.saveStateBlobStore.removeUnreferencedBlobs()
+            Logger.database.info("Save state blob store contains \(statistics.blobCount) blob(s) referenced by \(statistics.referenceCount) save state(s), saving \(statistics.deduplicatedSize) bytes.")
+            
             completion()
         }
     }
 }
 
 //MARK: - Importing -
+private extension DatabaseManager
+{
+    struct ImportedGameFile
+    {
+        // The original file URL, or <archive URL>/<entry path> for games imported from archives.
+        var url: URL
+        var identifier: String
+        var gameType: GameType
+        var system: System
+        
+        // True if this import created the file in the Games directory, so we know to remove it if saving fails.
+        var isNewFile = false
+        
+        var filename: String {
+            return self.identifier + "." + self.url.pathExtension
+        }
+    }
+}
+
 /// Importing
 extension DatabaseManager
 {
@@ -357,112 +365,86 @@ extension DatabaseManager
             return
         }
         
-        let zipFileURLs = urls.filter { $0.pathExtension.lowercased() == "zip" }
-        if zipFileURLs.count > 0
-        {
-            self.extractCompressedGames(at: Set(zipFileURLs)) { (extractedURLs, extractErrors) in
-                let gameURLs = urls.filter { $0.pathExtension.lowercased() != "zip" } + extractedURLs
-                self.importGames(at: Set(gameURLs)) { (importedGames, importErrors) in
-                    let allErrors = importErrors.union(extractErrors)
-                    completion?(importedGames, allErrors)
-                }
-            }
+        DispatchQueue.global(qos: .userInitiated).async {
             
-            return
-        }
-        
-        self.performBackgroundTask { (context) in
+            // Hash and move files concurrently (bounded by the number of cores), then insert all games using a single context.
+            let zipFileURLs = urls.filter { $0.pathExtension.lowercased() == "zip" }
+            let gameFileURLs = urls.filter { $0.pathExtension.lowercased() != "zip" }
             
-            var errors = Set<ImportError>()
-            var identifiers = Set<String>()
+            // Archive entries are streamed straight into the Games directory rather than extracted to a temporary directory first.
+            let results = self.importGameFiles(at: Array(gameFileURLs)) + self.importCompressedGames(at: Array(zipFileURLs))
             
-            for url in urls
-            {
-                guard FileManager.default.fileExists(atPath: url.path) else {
-                    errors.insert(.doesNotExist(url))
-                    continue
-                }
-                
-                guard let gameType = GameType(fileExtension: url.pathExtension), let system = System(gameType: gameType) else {
-                    errors.insert(.unsupported(url))
-                    continue
-                }
+            self.performBackgroundTask { (context) in
                 
-                guard System.registeredSystems.contains(system) else {
-                    errors.insert(.unsupported(url))
-                    continue
-                }
+                var errors = Set<ImportError>()
+                var identifiers = Set<String>()
                 
-                let identifier: String
+                var importedFiles = [ImportedGameFile]()
                 
-                do
+                for result in results
                 {
-                    identifier = try RSTHasher.sha1HashOfFile(at: url)
-                }
-                catch let error as NSError
-                {
-                    errors.insert(.unknown(url, error))
-                    continue
+                    switch result
+                    {
+                    case .success(let importedFile): importedFiles.append(importedFile)
+                    case .failure(let error): errors.insert(error)
+                    }
                 }
                 
-                let filename = identifier + "." + url.pathExtension
-                
-                let game = Game(context: context)
-                game.identifier = identifier
-                game.type = gameType
-                game.filename = filename
+                // Resolve metadata for all games at once rather than querying the games database once per game.
+                let metadataByIdentifier = self.gamesDatabase?.metadata(forSHA1Hashes: importedFiles.map { $0.identifier }) ?? [:]
                 
-                let databaseMetadata = self.gamesDatabase?.metadata(for: game)
-                game.name = databaseMetadata?.name ?? url.deletingPathExtension().lastPathComponent
-                game.artworkURL = databaseMetadata?.artworkURL
-                
-                let gameCollection = GameCollection(context: context)
-                gameCollection.identifier = gameType.rawValue
-                gameCollection.index = Int16(system.year)
-                gameCollection.games.insert(game)
-                
-                do
+                for importedFile in importedFiles
                 {
-                    let destinationURL = DatabaseManager.gamesDirectoryURL.appendingPathComponent(filename)
+                    let game = Game(context: context)
+                    game.identifier = importedFile.identifier
+                    game.type = importedFile.gameType
+                    game.filename = importedFile.filename
                     
-                    if FileManager.default.fileExists(atPath: destinationURL.path)
-                    {
-                        // Game already exists, so we choose not to override it and just delete the new game instead
-                        try FileManager.default.removeItem(at: url)
-                    }
-                    else
-                    {
-                        try FileManager.default.moveItem(at: url, to: destinationURL)
-                    }
+                    let databaseMetadata = metadataByIdentifier[importedFile.identifier]
+                    game.name = databaseMetadata?.name ?? importedFile.url.deletingPathExtension().lastPathComponent
+                    game.artworkURL = databaseMetadata?.artworkURL
+                    
+                    let gameCollection = GameCollection(context: context)
+                    gameCollection.identifier = importedFile.gameType.rawValue
+                    gameCollection.index = Int16(importedFile.system.year)
+                    gameCollection.games.insert(game)
                     
                     identifiers.insert(game.identifier)
                 }
+                
+                do
+                {
+                    try context.save()
+                }
                 catch let error as NSError
                 {
-                    print("Import Games error:", error)
-                    game.managedObjectContext?.delete(game)
+                    print("Failed to save import context:", error)
                     
-                    errors.insert(.unknown(url, error))
+                    identifiers.removeAll()
+                    
+                    errors.insert(.saveFailed(urls, error))
+                    
+                    // Don't leave behind game files that no Game references.
+                    for importedFile in importedFiles where importedFile.isNewFile
+                    {
+                        let fileURL = DatabaseManager.gamesDirectoryURL.appendingPathComponent(importedFile.filename)
+                        
+                        do
+                        {
+                            try FileManager.default.removeItem(at: fileURL)
+                        }
+                        catch
+                        {
+                            print(error)
+                        }
+                    }
                 }
-            }
-
-            do
-            {
-                try context.save()
-            }
-            catch let error as NSError
-            {
-                print("Failed to save import context:", error)
-                
-                identifiers.removeAll()
                 
-                errors.insert(.saveFailed(urls, error))
-            }
-            
-            DatabaseManager.shared.viewContext.perform {
-                let predicate = NSPredicate(format: "%K IN (%@)", #keyPath(Game.identifier), identifiers)
-                let games = Game.instancesWithPredicate(predicate, inManagedObjectContext: DatabaseManager.shared.viewContext, type: Game.self)
-                completion?(Set(games), errors)
+                DatabaseManager.shared.viewContext.perform {
+                    let predicate = NSPredicate(format: "%K IN (%@)", #keyPath(Game.identifier), identifiers)
+                    let games = Game.instancesWithPredicate(predicate, inManagedObjectContext: DatabaseManager.shared.viewContext, type: Game.self)
+                    completion?(Set(games), errors)
+                }
             }
         }
     }
@@ -551,85 +533,242 @@ extension DatabaseManager
         }
     }
     
-    private func extractCompressedGames(at urls: Set<URL>, completion: @escaping ((Set<URL>, Set<ImportError>) -> Void))
+    private func importGameFiles(at urls: [URL]) -> [Result<ImportedGameFile, ImportError>]
     {
-        DispatchQueue.global().async {
+        let gamesDirectoryURL = DatabaseManager.gamesDirectoryURL
+        
+        var results = [Result<ImportedGameFile, ImportError>?](repeating: nil, count: urls.count)
+        let lock = NSLock()
+        
+        // Files already written to the Games directory while hashing, so they don't need to be moved afterwards.
+        var copiedIndexes = Set<Int>()
+        
+        func hashFile(at url: URL, index: Int) -> Result<ImportedGameFile, ImportError>
+        {
+            guard FileManager.default.fileExists(atPath: url.path) else { return .failure(.doesNotExist(url)) }
             
-            var outputURLs = Set<URL>()
-            var errors = Set<ImportError>()
+            guard let gameType = GameType(fileExtension: url.pathExtension), let system = System(gameType: gameType), System.registeredSystems.contains(system) else {
+                return .failure(.unsupported(url))
+            }
             
-            for url in urls
+            do
             {
-                var archiveContainsValidGameFile = false
-                let archive: Archive
-                
-                do
-                {
-                    archive = try Archive(url: url, accessMode: .read)
-                }
-                catch
-                {
-                    errors.insert(.unknown(url, error as NSError))
-                    continue
-                }
-                
-                for entry in archive
-                {
-                    do
-                    {
-                        // Ensure entry is not in a subdirectory
-                        guard !entry.path.contains("/") else { continue }
-                        
-                        let fileExtension = (entry.path as NSString).pathExtension
+                guard FileManager.default.isItem(at: url, onSameVolumeAs: gamesDirectoryURL) else {
+                    // Moving across volumes copies the file anyway, so hash it while copying rather than reading it twice.
+                    let (identifier, isNewFile) = try FileManager.default.writeItemNamedBySHA1Hash(toDirectory: gamesDirectoryURL, pathExtension: url.pathExtension) { (write) in
+                        let fileHandle = try FileHandle(forReadingFrom: url)
+                        defer { try? fileHandle.close() }
                         
-                        guard GameType(fileExtension: fileExtension) != nil else { continue }
-                        
-                        // At least one entry is a valid game file, so we set archiveContainsValidGameFile to true
-                        // This will result in this archive being considered valid, and thus we will not return an ImportError.invalid error for the archive
-                        // However, if this game file does turn out to be invalid when extracting, we'll return an ImportError.invalid error specific to this game file
-                        archiveContainsValidGameFile = true
-                        
-                        // Must use temporary directory, and not the directory containing zip file, since the latter might be read-only (such as when importing from Safari)
-                        let outputURL = FileManager.default.temporaryDirectory.appendingPathComponent(entry.path)
-                        
-                        if FileManager.default.fileExists(atPath: outputURL.path)
+                        while let data = try autoreleasepool(invoking: { try fileHandle.read(upToCount: FileManager.hashingChunkSize) }), !data.isEmpty
                         {
-                            try FileManager.default.removeItem(at: outputURL)
+                            try write(data)
                         }
-                        
-                        _ = try archive.extract(entry, to: outputURL, skipCRC32: true)
-                        
-                        outputURLs.insert(outputURL)
+                    }
+                    
+                    do
+                    {
+                        // Game was imported successfully, so failing to remove original isn't fatal.
+                        try FileManager.default.removeItem(at: url)
                     }
                     catch
                     {
                         print(error)
                     }
+                    
+                    lock.withLock { _ = copiedIndexes.insert(index) }
+                    
+                    let importedFile = ImportedGameFile(url: url, identifier: identifier, gameType: gameType, system: system, isNewFile: isNewFile)
+                    return .success(importedFile)
                 }
                 
-                if !archiveContainsValidGameFile
-                {
-                    errors.insert(.invalid(url))
-                }
+                // Same volume, so moving is just a rename and hashing is the only read.
+                let identifier = try FileManager.default.sha1Hash(ofItemAt: url)
+                
+                let importedFile = ImportedGameFile(url: url, identifier: identifier, gameType: gameType, system: system)
+                return .success(importedFile)
             }
+            catch let error as NSError
+            {
+                print("Import Games error:", error)
+                return .failure(.unknown(url, error))
+            }
+        }
+        
+        // concurrentPerform limits the number of worker threads to the number of active cores.
+        DispatchQueue.concurrentPerform(iterations: urls.count) { (index) in
+            let result = hashFile(at: urls[index], index: index)
             
-            for url in urls
+            lock.lock()
+            results[index] = result
+            lock.unlock()
+        }
+        
+        // Group files by destination before moving any, so identical games in the same batch are moved once instead of racing for the same file.
+        var indexesByFilename = [String: [Int]]()
+        for (index, result) in results.enumerated() where !copiedIndexes.contains(index)
+        {
+            guard case .success(let importedFile)? = result else { continue }
+            indexesByFilename[importedFile.filename, default: []].append(index)
+        }
+        
+        let duplicateIndexes = Array(indexesByFilename.values)
+        
+        DispatchQueue.concurrentPerform(iterations: duplicateIndexes.count) { (index) in
+            let indexes = duplicateIndexes[index]
+            
+            lock.lock()
+            var importedFiles = indexes.compactMap { try? results[$0]?.get() }
+            lock.unlock()
+            
+            do
             {
-                if FileManager.default.fileExists(atPath: url.path)
+                // If game already exists, we choose not to override it and just delete the new game instead.
+                let destinationURL = gamesDirectoryURL.appendingPathComponent(importedFiles[0].filename)
+                importedFiles[0].isNewFile = try FileManager.default.moveItemIfNeeded(at: importedFiles[0].url, to: destinationURL)
+                
+                for importedFile in importedFiles.dropFirst()
                 {
                     do
                     {
-                        try FileManager.default.removeItem(at: url)
+                        try FileManager.default.removeItem(at: importedFile.url)
                     }
                     catch
                     {
                         print(error)
                     }
                 }
+                
+                lock.lock()
+                zip(indexes, importedFiles).forEach { results[$0] = .success($1) }
+                lock.unlock()
+            }
+            catch let error as NSError
+            {
+                print("Import Games error:", error)
+                
+                lock.lock()
+                zip(indexes, importedFiles).forEach { results[$0] = .failure(.unknown($1.url, error)) }
+                lock.unlock()
             }
+        }
+        
+        return results.compactMap { $0 }
+    }
+    
+    private func importCompressedGames(at urls: [URL]) -> [Result<ImportedGameFile, ImportError>]
+    {
+        let gamesDirectoryURL = DatabaseManager.gamesDirectoryURL
+        
+        var results = [Result<ImportedGameFile, ImportError>]()
+        let lock = NSLock()
+        
+        func importGames(inArchiveAt url: URL) -> [Result<ImportedGameFile, ImportError>]
+        {
+            var archiveResults = [Result<ImportedGameFile, ImportError>]()
+            var archiveContainsValidGameFile = false
             
-            completion(outputURLs, errors)
+            let archive: Archive
+            
+            do
+            {
+                archive = try Archive(url: url, accessMode: .read)
+            }
+            catch
+            {
+                return [.failure(.unknown(url, error as NSError))]
+            }
+            
+            for entry in archive
+            {
+                // Ensure entry is not in a subdirectory
+                guard !entry.path.contains("/") else { continue }
+                
+                let fileExtension = (entry.path as NSString).pathExtension
+                
+                guard let gameType = GameType(fileExtension: fileExtension), let system = System(gameType: gameType) else { continue }
+                
+                // At least one entry is a valid game file, so we set archiveContainsValidGameFile to true
+                // This will result in this archive being considered valid, and thus we will not return an ImportError.invalid error for the archive
+                // However, if this game file does turn out to be invalid when extracting, we'll return an ImportError specific to this game file
+                archiveContainsValidGameFile = true
+                
+                // Identifies the entry for error reporting and default naming purposes; nothing is written to this URL.
+                let entryURL = url.appendingPathComponent(entry.path)
+                
+                guard System.registeredSystems.contains(system) else {
+                    archiveResults.append(.failure(.unsupported(entryURL)))
+                    continue
+                }
+                
+                // The central directory stores each entry's CRC32, so we can tell whether we've imported this game before without inflating it.
+                let crc32 = entry.checksum
+                let size = UInt64(entry.uncompressedSize)
+                
+                if let identifier = self.gameChecksumIndex.identifier(forCRC32: crc32, size: size)
+                {
+                    let existingFileURL = gamesDirectoryURL.appendingPathComponent(identifier).appendingPathExtension(fileExtension)
+                    if FileManager.default.fileExists(atPath: existingFileURL.path)
+                    {
+                        let importedFile = ImportedGameFile(url: entryURL, identifier: identifier, gameType: gameType, system: system)
+                        archiveResults.append(.success(importedFile))
+                        continue
+                    }
+                }
+                
+                do
+                {
+                    // Inflate entry once, hashing it while writing directly to <sha1>.<ext> in the Games directory.
+                    let (identifier, isNewFile) = try FileManager.default.writeItemNamedBySHA1Hash(toDirectory: gamesDirectoryURL, pathExtension: fileExtension) { (write) in
+                        _ = try archive.extract(entry, skipCRC32: true, consumer: write)
+                    }
+                    
+                    self.gameChecksumIndex.setIdentifier(identifier, forCRC32: crc32, size: size)
+                    
+                    let importedFile = ImportedGameFile(url: entryURL, identifier: identifier, gameType: gameType, system: system, isNewFile: isNewFile)
+                    archiveResults.append(.success(importedFile))
+                }
+                catch
+                {
+                    print("Import Games error:", error)
+                    archiveResults.append(.failure(.unknown(entryURL, error as NSError)))
+                }
+            }
+            
+            if !archiveContainsValidGameFile
+            {
+                archiveResults.append(.failure(.invalid(url)))
+            }
+            
+            return archiveResults
         }
+        
+        // Archives can't be read concurrently, but separate archives can be imported in parallel.
+        DispatchQueue.concurrentPerform(iterations: urls.count) { (index) in
+            let archiveResults = importGames(inArchiveAt: urls[index])
+            
+            lock.lock()
+            results.append(contentsOf: archiveResults)
+            lock.unlock()
+        }
+        
+        self.gameChecksumIndex.save()
+        
+        for url in urls
+        {
+            if FileManager.default.fileExists(atPath: url.path)
+            {
+                do
+                {
+                    try FileManager.default.removeItem(at: url)
+                }
+                catch
+                {
+                    print(error)
+                }
+            }
+        }
+        
+        return results
     }
     
     private func importExternalFiles(at urls: Set<URL>, completion: @escaping ((Set<URL>, Set<ImportError>) -> Void))
@@ -694,6 +833,12 @@ extension DatabaseManager
         return gamesDatabaseURL
     }
 
+    class var gameChecksumIndexURL: URL
+    {
+        let gameChecksumIndexURL = self.defaultDirectoryURL().appendingPathComponent("GameChecksums.plist")
+        return gameChecksumIndexURL
+    }
+    
     class var gamesDirectoryURL: URL
     {
         let gamesDirectoryURL = DatabaseManager.defaultDirectoryURL().appendingPathComponent("Games")
@@ -710,6 +855,14 @@ extension DatabaseManager
         return saveStatesDirectoryURL
     }
     
+    class var saveStateBlobsDirectoryURL: URL
+    {
+        let blobsDirectoryURL = DatabaseManager.saveStatesDirectoryURL.appendingPathComponent("Blobs")
+        self.createDirectory(at: blobsDirectoryURL)
+        
+        return blobsDirectoryURL
+    }
+    
     class func saveStatesDirectoryURL(for game: Game) -> URL
     {
         let gameDirectoryURL = DatabaseManager.saveStatesDirectoryURL.appendingPathComponent(game.identifier)
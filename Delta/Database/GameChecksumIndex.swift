@@ -0,0 +1,100 @@
+//
+//  GameChecksumIndex.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Maps (CRC32, size) pairs to the identifiers (SHA-1 hashes) of previously imported games.
+// Allows importing archives to skip entries we've already imported using just the CRC32 from the zip's central directory,
+// rather than inflating + hashing them again only to discover they already exist.
+final class GameChecksumIndex
+{
+    let fileURL: URL
+    
+    private var identifiersByChecksum: [String: String]
+    private var isDirty = false
+    
+    private let lock = NSLock()
+    
+    init(fileURL: URL)
+    {
+        self.fileURL = fileURL
+        
+        do
+        {
+            let data = try Data(contentsOf: fileURL)
+            self.identifiersByChecksum = try PropertyListDecoder().decode([String: String].self, from: data)
+        }
+        catch CocoaError.fileReadNoSuchFile
+        {
+            self.identifiersByChecksum = [:]
+        }
+        catch
+        {
+            Logger.database.error("Failed to load game checksum index, starting from scratch. \(error.localizedDescription, privacy: .public)")
+            self.identifiersByChecksum = [:]
+        }
+    }
+}
+
+extension GameChecksumIndex
+{
+    func identifier(forCRC32 crc32: UInt32, size: UInt64) -> String?
+    {
+        let key = self.key(forCRC32: crc32, size: size)
+        
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        return self.identifiersByChecksum[key]
+    }
+    
+    func setIdentifier(_ identifier: String, forCRC32 crc32: UInt32, size: UInt64)
+    {
+        let key = self.key(forCRC32: crc32, size: size)
+        
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        guard self.identifiersByChecksum[key] != identifier else { return }
+        
+        self.identifiersByChecksum[key] = identifier
+        self.isDirty = true
+    }
+    
+    func save()
+    {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        guard self.isDirty else { return }
+        
+        do
+        {
+            let encoder = PropertyListEncoder()
+            encoder.outputFormat = .binary
+            
+            let data = try encoder.encode(self.identifiersByChecksum)
+            try data.write(to: self.fileURL, options: .atomic)
+            
+            self.isDirty = false
+        }
+        catch
+        {
+            Logger.database.error("Failed to save game checksum index. \(error.localizedDescription, privacy: .public)")
+        }
+    }
+}
+
+private extension GameChecksumIndex
+{
+    func key(forCRC32 crc32: UInt32, size: UInt64) -> String
+    {
+        let key = String(format: "%08x-%llu", crc32, size)
+        return key
+    }
+}
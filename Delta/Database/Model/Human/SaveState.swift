@@ -84,7 +84,7 @@ public class SaveState: _SaveState, SaveStateProtocol
         
         do
         {
-            try FileManager.default.removeItem(at: self.fileURL)
+            try DatabaseManager.shared.saveStateBlobStore.removeItem(at: self.fileURL)
             try FileManager.default.removeItem(at: self.imageFileURL)
         }
         catch
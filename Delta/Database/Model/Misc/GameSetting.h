@@ -13,3 +13,4 @@ FOUNDATION_EXPORT GameSetting const GameSettingOpenGLES2;
 FOUNDATION_EXPORT GameSetting const GameSettingNoExternalControllerSkin;
 FOUNDATION_EXPORT GameSetting const GameSettingRetroAchievementsEnabled;
 FOUNDATION_EXPORT GameSetting const GameSettingFastForwardSpeed;
+FOUNDATION_EXPORT GameSetting const GameSettingRunAheadFrames;
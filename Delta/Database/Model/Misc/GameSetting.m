@@ -12,3 +12,4 @@ GameSetting const GameSettingOpenGLES2 = @"DLTAOpenGLES2";
 GameSetting const GameSettingNoExternalControllerSkin = @"DLTANoExternalControllerSkin";
 GameSetting const GameSettingRetroAchievementsEnabled = @"DLTARetroAchievementsEnabled";
 GameSetting const GameSettingFastForwardSpeed = @"DLTAFastForwardSpeed";
+GameSetting const GameSettingRunAheadFrames = @"DLTARunAheadFrames";
@@ -8,6 +8,7 @@
 
 import Foundation
 import SQLite
+import SQLite3
 
 // Prefer SQLite's Expression over iOS 18's new Foundation.Expression
 private typealias Expression = SQLite.Expression
@@ -53,9 +54,19 @@ extension Table
 
 extension VirtualTable
 {
+    // Legacy FTS4 table, replaced by searchIndex.
     static var search: VirtualTable {
         return VirtualTable("Search")
     }
+    
+    static var searchIndex: VirtualTable {
+        return VirtualTable("SearchIndex")
+    }
+}
+
+extension GamesDatabase
+{
+    static let didPrepareSearchIndexNotification = Notification.Name("GamesDatabaseDidPrepareSearchIndexNotification")
 }
 
 extension GamesDatabase
@@ -74,19 +85,63 @@ extension GamesDatabase
     }
 }
 
+// Decodes metadata(forSHA1Hashes:) rows by column index (in the order they're selected),
+// rather than resolving every column by name for every row.
+private struct ReleaseRow
+{
+    var sha1Hash: String
+    var releaseID: Int
+    var name: String?
+    var artworkAddress: String?
+    var romID: Int
+    
+    init(_ cursor: Cursor)
+    {
+        self.sha1Hash = cursor[0]
+        self.releaseID = cursor[1]
+        self.name = cursor[2] as Binding? as? String
+        self.artworkAddress = cursor[3] as Binding? as? String
+        self.romID = cursor[4]
+    }
+}
+
 class GamesDatabase
 {
     static let version = 3
+    
+    // SQLite limits the number of bound parameters per statement (999 on older versions).
+    private static let maximumBatchSize = 500
+    
+    // Stored as the database's user_version once the search index has been completely built.
+    // Bump to rebuild the search index without needing to replace the entire database.
+    private static let searchIndexVersion: Int64 = 1001
+    private static let searchIndexBatchSize = 2000
+    
+    // Only one connection should build the search index at a time.
+    private static let searchIndexQueue = DispatchQueue(label: "com.rileytestut.Delta.GamesDatabase.searchIndex", qos: .utility)
+    
+    // Reports progress building the search index. Completed once search index is ready.
+    static let searchIndexProgress = Progress.discreteProgress(totalUnitCount: 1)
+    
     static var previousVersion: Int? {
         return UserDefaults.standard.previousGamesDatabaseVersion
     }
     
+    // Used for building indexes. All other queries go through readerPool so they can run concurrently.
     private let connection: Connection
+    private let readerPool: ReadOnlyConnectionPool
+    
+    // Cached so checking doesn't need to wait for connection, which may be busy building the search index.
+    var isSearchIndexReady: Bool {
+        get { self.lock.withLock { self._isSearchIndexReady } }
+        set { self.lock.withLock { self._isSearchIndexReady = newValue } }
+    }
+    private var _isSearchIndexReady = false
     
-    init() throws
+    private let lock = NSLock()
+    
+    init(fileURL: URL = DatabaseManager.gamesDatabaseURL) throws
     {
-        let fileURL = DatabaseManager.gamesDatabaseURL
-        
         do
         {
             self.connection = try Connection(fileURL.path)
@@ -96,21 +151,42 @@ class GamesDatabase
             throw error
         }
         
+        // Database won't be modified again once search index has been built, so readers can skip file locking.
+        let isSearchIndexReady = GamesDatabase.isSearchIndexReady(in: self.connection)
+        self.readerPool = ReadOnlyConnectionPool(fileURL: fileURL, isImmutable: isSearchIndexReady)
+        
+        self._isSearchIndexReady = isSearchIndexReady
+        
+        self.prepareIndexes()
         self.invalidateVirtualTableIfNeeded()
     }
     
-    func metadataResults(forGameName gameName: String) -> [GameMetadata]
+    // Returns up to `limit` results starting at `offset`, ordered by relevance. Returns empty array if search index isn't ready yet.
+    // The query is interrupted (returning no results) as soon as `isCancelled` returns true.
+    func metadataResults(forGameName gameName: String, limit: Int = 50, offset: Int = 0, isCancelled: (() -> Bool)? = nil) -> [GameMetadata]
     {
         let releaseID = Expression<Any>.releaseID
         let romID = Expression<Any>.romID
         let name = Expression<Any>.name
         let artworkAddress = Expression<Any>.artworkAddress
         
-        let query = VirtualTable.search.select(releaseID, romID, name, artworkAddress).filter(name.match(gameName + "*"))
+        // Quote each word and treat it as a prefix, so punctuation (e.g. "Pokémon: Red") isn't interpreted as FTS5 query syntax.
+        let tokens = gameName.components(separatedBy: CharacterSet.alphanumerics.inverted).filter { !$0.isEmpty }
+        guard !tokens.isEmpty else { return [] }
+        
+        let pattern = tokens.map { "\"" + $0 + "\"*" }.joined(separator: " ")
+        
+        let rank = Expression<Double>(literal: "rank")
+        let query = VirtualTable.searchIndex.match(pattern).select(releaseID, romID, name, artworkAddress).order(rank).limit(limit, offset: offset)
         
         do
         {
-            let rows = try self.connection.prepare(query)
+            let rows = try self.readerPool.withReader { (reader) in
+                reader.connection.progressHandler(isCancelled)
+                defer { reader.connection.progressHandler(nil) }
+                
+                return try Array(reader.connection.prepare(query))
+            }
             
             let results = rows.map { (row) -> GameMetadata in
 
@@ -131,15 +207,14 @@ class GamesDatabase
             
             return results
         }
-            
         catch SQLite.Result.error(_, let code, _) where code == 1
         {
-            // Table does not exist
-            
-            if self.prepareFTS()
-            {
-                return self.metadataResults(forGameName: gameName)
-            }
+            // Table does not exist yet, so kick off building it (if not already in progress).
+            self.prepareSearchIndexIfNeeded()
+        }
+        catch SQLite.Result.error(_, let code, _) where code == SQLITE_INTERRUPT
+        {
+            // Cancelled, so results are no longer needed.
         }
         catch
         {
@@ -149,7 +224,38 @@ class GamesDatabase
         return []
     }
     
+    // Builds full-text search index in the background, posting didPrepareSearchIndexNotification when finished.
+    func prepareSearchIndexIfNeeded()
+    {
+        GamesDatabase.searchIndexQueue.async {
+            guard !self.isSearchIndexReady else {
+                GamesDatabase.searchIndexProgress.completedUnitCount = GamesDatabase.searchIndexProgress.totalUnitCount
+                return
+            }
+            
+            do
+            {
+                try self.prepareSearchIndex()
+                
+                self.isSearchIndexReady = true
+                
+                NotificationCenter.default.post(name: GamesDatabase.didPrepareSearchIndexNotification, object: nil)
+            }
+            catch
+            {
+                Logger.database.error("Failed to prepare games database search index. \(error.localizedDescription, privacy: .public)")
+            }
+        }
+    }
+    
     func metadata(for game: Game) -> GameMetadata?
+    {
+        let metadata = self.metadata(forSHA1Hashes: [game.identifier])
+        return metadata[game.identifier]
+    }
+    
+    // Returns metadata keyed by the provided hashes. Hashes without a matching release are omitted.
+    func metadata<S: Sequence>(forSHA1Hashes hashes: S) -> [String: GameMetadata] where S.Element == String
     {
         let releaseID = Expression<Any>.releaseID
         let name = Expression<Any>.name
@@ -158,25 +264,48 @@ class GamesDatabase
         let sha1Hash = Expression<Any>.sha1Hash
         let romID = Expression<Any>.romID
         
-        let gameHash = game.identifier.uppercased()
-        let query = Table.roms.select(releaseID, name, artworkAddress, Table.roms[romID]).filter(sha1Hash == gameHash).join(Table.releases, on: Table.roms[romID] == Table.releases[romID])
+        // OpenVGDB stores uppercase hashes, but callers may use any case.
+        var hashesByDatabaseHash = [String: String]()
+        for hash in hashes
+        {
+            hashesByDatabaseHash[hash.uppercased()] = hash
+        }
+        
+        let databaseHashes = Array(hashesByDatabaseHash.keys)
+        var metadataByHash = [String: GameMetadata]()
         
         do
         {
-            if let row = try self.connection.pluck(query)
+            for startIndex in stride(from: 0, to: databaseHashes.count, by: GamesDatabase.maximumBatchSize)
             {
-                let artworkURL: URL?
-                if let address = row[artworkAddress]
-                {
-                    artworkURL = URL(string: address)
-                }
-                else
-                {
-                    artworkURL = nil
-                }
+                let endIndex = min(startIndex + GamesDatabase.maximumBatchSize, databaseHashes.count)
+                let batch = Array(databaseHashes[startIndex ..< endIndex])
                 
-                let metadata = GameMetadata(releaseID: row[releaseID], romID: row[Table.roms[romID]], name: row[name], artworkURL: artworkURL)
-                return metadata
+                let query = Table.roms.select(sha1Hash, releaseID, name, artworkAddress, Table.roms[romID]).filter(batch.contains(sha1Hash)).join(Table.releases, on: Table.roms[romID] == Table.releases[romID])
+                
+                let expression = query.expression
+                try self.readerPool.withReader { (reader) in
+                    try reader.statementCache.withStatement(expression.template, expression.bindings) { (statement) in
+                        while try statement.step()
+                        {
+                            let row = ReleaseRow(statement.row)
+                            guard let hash = hashesByDatabaseHash[row.sha1Hash], metadataByHash[hash] == nil else { continue }
+                            
+                            let artworkURL: URL?
+                            if let address = row.artworkAddress
+                            {
+                                artworkURL = URL(string: address)
+                            }
+                            else
+                            {
+                                artworkURL = nil
+                            }
+                            
+                            let metadata = GameMetadata(releaseID: row.releaseID, romID: row.romID, name: row.name, artworkURL: artworkURL)
+                            metadataByHash[hash] = metadata
+                        }
+                    }
+                }
             }
         }
         catch
@@ -184,18 +313,51 @@ class GamesDatabase
             print(error)
         }
         
-        return nil
+        return metadataByHash
     }
 }
 
 private extension GamesDatabase
 {
+    static func isSearchIndexReady(in connection: Connection) -> Bool
+    {
+        do
+        {
+            let userVersion = try connection.scalar("PRAGMA user_version") as? Int64
+            return userVersion == GamesDatabase.searchIndexVersion
+        }
+        catch
+        {
+            print(error)
+            return false
+        }
+    }
+    
+    func prepareIndexes()
+    {
+        // The bundled OpenVGDB database has no indexes on the columns used to look up games by hash,
+        // so build them once after installing a new version (no-op if they already exist).
+        let sha1Hash = Expression<Any>.sha1Hash
+        let romID = Expression<Any>.romID
+        
+        do
+        {
+            try self.connection.run(Table.roms.createIndex(sha1Hash, romID, ifNotExists: true))
+            try self.connection.run(Table.releases.createIndex(romID, ifNotExists: true))
+        }
+        catch
+        {
+            print(error)
+        }
+    }
+    
     func invalidateVirtualTableIfNeeded()
     {
         guard UserDefaults.standard.previousGamesDatabaseVersion != GamesDatabase.version else { return }
         
         do
         {
+            // Legacy FTS4 table is no longer used.
             try self.connection.run(VirtualTable.search.drop(ifExists: true))
             
             UserDefaults.standard.previousGamesDatabaseVersion = GamesDatabase.version
@@ -206,26 +368,47 @@ private extension GamesDatabase
         }
     }
     
-    func prepareFTS() -> Bool
+    func prepareSearchIndex() throws
     {
         let name = Expression<Any>.name
         let artworkAddress = Expression<Any>.artworkAddress
         let releaseID = Expression<Any>.releaseID
         let romID = Expression<Any>.romID
         
-        do
+        // Only the name is searchable, but store remaining columns so results don't require a join.
+        // Prefix indexes make "word*" queries fast while typing.
+        let config = FTS5Config()
+            .column(name)
+            .column(releaseID, [.unindexed])
+            .column(romID, [.unindexed])
+            .column(artworkAddress, [.unindexed])
+            .prefix([2, 3])
+        
+        try self.connection.run(VirtualTable.searchIndex.drop(ifExists: true))
+        try self.connection.run(VirtualTable.searchIndex.create(.FTS5(config)))
+        
+        guard
+            let minimumReleaseID = try self.connection.scalar(Table.releases.select(releaseID.min)),
+            let maximumReleaseID = try self.connection.scalar(Table.releases.select(releaseID.max))
+        else { return }
+        
+        let progress = GamesDatabase.searchIndexProgress
+        progress.totalUnitCount = Int64((maximumReleaseID - minimumReleaseID) / GamesDatabase.searchIndexBatchSize + 1)
+        progress.completedUnitCount = 0
+        
+        // Insert in batches so other queries on this connection (e.g. import metadata lookups) aren't blocked for the entire build.
+        for lowerBound in stride(from: minimumReleaseID, through: maximumReleaseID, by: GamesDatabase.searchIndexBatchSize)
         {
-            try self.connection.run(VirtualTable.search.create(.FTS4([releaseID, romID, name, artworkAddress], tokenize: .Unicode61())))
+            let upperBound = lowerBound + GamesDatabase.searchIndexBatchSize
             
-            let update = VirtualTable.search.insert(Table.releases.select(releaseID, romID, name, artworkAddress))
-            _ = try self.connection.run(update)
-        }
-        catch
-        {
-            print(error)
-            return false
+            let releases = Table.releases.select(name, releaseID, romID, artworkAddress).filter(releaseID >= lowerBound && releaseID < upperBound)
+            try self.connection.run(VirtualTable.searchIndex.insert(releases))
+            
+            progress.completedUnitCount += 1
         }
         
-        return true
+        try self.connection.run("PRAGMA user_version = \(GamesDatabase.searchIndexVersion)")
+        
+        progress.completedUnitCount = progress.totalUnitCount
     }
 }
@@ -21,6 +21,14 @@ class GamesDatabaseBrowserViewController: UITableViewController
     
     private let dataSource: RSTArrayTableViewPrefetchingDataSource<GameMetadata, UIImage>
     
+    // Results are loaded one page at a time as the user scrolls.
+    private let pageSize = 50
+    private var searchResultsText: String?
+    private var hasMoreSearchResults = false
+    private var isLoadingNextPage = false
+    
+    private var searchIndexProgressObservation: NSKeyValueObservation?
+    
     override init(style: UITableView.Style) {
         fatalError()
     }
@@ -44,6 +52,14 @@ class GamesDatabaseBrowserViewController: UITableViewController
         self.definesPresentationContext = true
         
         self.prepareDataSource()
+        
+        NotificationCenter.default.addObserver(self, selector: #selector(GamesDatabaseBrowserViewController.gamesDatabaseDidPrepareSearchIndex(_:)), name: GamesDatabase.didPrepareSearchIndexNotification, object: nil)
+        
+        self.searchIndexProgressObservation = GamesDatabase.searchIndexProgress.observe(\.fractionCompleted) { [weak self] (progress, change) in
+            DispatchQueue.main.async {
+                self?.updatePlaceholderView()
+            }
+        }
     }
     
     override var preferredStatusBarStyle: UIStatusBarStyle {
@@ -72,6 +88,9 @@ class GamesDatabaseBrowserViewController: UITableViewController
         
         self.updatePlaceholderView()
         
+        // Normally already built in background after launch, but just in case.
+        self.database?.prepareSearchIndexIfNeeded()
+        
         if let searchText
         {
             // Manually update results
@@ -143,13 +162,17 @@ private extension GamesDatabaseBrowserViewController
         {
             self.dataSource.searchController.searchHandler = { [unowned self, unowned database] (searchValue, previousSearchValue) in
                 return RSTBlockOperation() { [unowned self, unowned database] (operation) in
-                    let results = database.metadataResults(forGameName: searchValue.text)
+                    let results = database.metadataResults(forGameName: searchValue.text, limit: self.pageSize, isCancelled: { operation.isCancelled })
                     
                     guard !operation.isCancelled else { return }
                     
-                    self.dataSource.items = results
-                    
                     rst_dispatch_sync_on_main_thread {
+                        self.searchResultsText = searchValue.text
+                        self.hasMoreSearchResults = (results.count == self.pageSize)
+                        self.isLoadingNextPage = false
+                        
+                        self.dataSource.items = results
+                        
                         self.resetTableViewContentOffset()
                         self.updatePlaceholderView()
                     }
@@ -174,11 +197,43 @@ private extension GamesDatabaseBrowserViewController
         cell.separatorInset.left = cell.nameLabel.frame.minX
     }
     
+    func loadNextPageIfNeeded(displaying indexPath: IndexPath)
+    {
+        guard let database = self.database, let searchText = self.searchResultsText else { return }
+        guard self.hasMoreSearchResults, !self.isLoadingNextPage else { return }
+        
+        let itemCount = self.dataSource.items.count
+        guard indexPath.row >= itemCount - 10 else { return }
+        
+        self.isLoadingNextPage = true
+        
+        DispatchQueue.global(qos: .userInitiated).async {
+            let results = database.metadataResults(forGameName: searchText, limit: self.pageSize, offset: itemCount)
+            
+            DispatchQueue.main.async {
+                // Ignore results if search changed while loading.
+                guard searchText == self.searchResultsText, itemCount == self.dataSource.items.count else { return }
+                
+                self.hasMoreSearchResults = (results.count == self.pageSize)
+                self.isLoadingNextPage = false
+                
+                self.dataSource.items += results
+            }
+        }
+    }
+    
     func updatePlaceholderView()
     {
         guard let placeholderView = self.dataSource.placeholderView as? RSTPlaceholderView else { return }
         
-        if self.dataSource.searchController.searchBar.text == ""
+        if let database = self.database, !database.isSearchIndexReady
+        {
+            let percentage = Int(GamesDatabase.searchIndexProgress.fractionCompleted * 100)
+            
+            placeholderView.textLabel.text = NSLocalizedString("Preparing Games Database…", comment: "")
+            placeholderView.detailTextLabel.text = String(format: NSLocalizedString("%@%% complete. You can search for games once the database is ready.", comment: ""), NSNumber(value: percentage))
+        }
+        else if self.dataSource.searchController.searchBar.text == ""
         {
             placeholderView.textLabel.text = NSLocalizedString("Games Database", comment: "")
             placeholderView.detailTextLabel.text = NSLocalizedString("To search the database, type the name of a game in the search bar.", comment: "")
@@ -197,8 +252,26 @@ private extension GamesDatabaseBrowserViewController
     }
 }
 
+private extension GamesDatabaseBrowserViewController
+{
+    @objc func gamesDatabaseDidPrepareSearchIndex(_ notification: Notification)
+    {
+        DispatchQueue.main.async {
+            self.updatePlaceholderView()
+            
+            // Re-run search now that index is available.
+            self.dataSource.searchController.updateSearchResults(for: self.dataSource.searchController)
+        }
+    }
+}
+
 extension GamesDatabaseBrowserViewController
 {
+    override func tableView(_ tableView: UITableView, willDisplay cell: UITableViewCell, forRowAt indexPath: IndexPath)
+    {
+        self.loadNextPageIfNeeded(displaying: indexPath)
+    }
+    
     override func tableView(_ tableView: UITableView, didSelectRowAt indexPath: IndexPath)
     {
         if self.dataSource.searchController.presentingViewController != nil
@@ -224,6 +297,8 @@ extension GamesDatabaseBrowserViewController: UISearchControllerDelegate
     {
         // Manually set items to empty array to prevent crash if user dismissses searchController while scrolling
         self.dataSource.items = []
+        self.searchResultsText = nil
+        self.hasMoreSearchResults = false
         self.updatePlaceholderView()
     }
     
@@ -0,0 +1,104 @@
+//
+//  ReadOnlyConnectionPool.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+import SQLite
+
+// Each SQLite.swift Connection serializes all statements on its own queue,
+// so we use a pool of read-only connections to allow concurrent queries against our reference databases (OpenVGDB + CheatBase).
+final class ReadOnlyConnectionPool
+{
+    struct Reader
+    {
+        let connection: Connection
+        let statementCache: StatementCache
+    }
+    
+    let fileURL: URL
+    
+    // If true, SQLite assumes the database file never changes and skips file locking entirely.
+    // Only safe once nothing will write to the database for the lifetime of the pool.
+    let isImmutable: Bool
+    
+    let maximumConnectionCount: Int
+    
+    // Memory-map the database so reads don't need to copy pages into SQLite's page cache.
+    private static let mmapSize = 256 * 1024 * 1024
+    
+    private var idleReaders = [Reader]()
+    
+    private let semaphore: DispatchSemaphore
+    private let lock = NSLock()
+    
+    init(fileURL: URL, isImmutable: Bool, maximumConnectionCount: Int = ProcessInfo.processInfo.activeProcessorCount)
+    {
+        self.fileURL = fileURL
+        self.isImmutable = isImmutable
+        self.maximumConnectionCount = max(maximumConnectionCount, 1)
+        
+        self.semaphore = DispatchSemaphore(value: self.maximumConnectionCount)
+    }
+    
+    // Passes an idle connection to `block`, opening a new one if needed. Blocks if all connections are in use.
+    func withReader<T>(_ block: (Reader) throws -> T) throws -> T
+    {
+        self.semaphore.wait()
+        defer { self.semaphore.signal() }
+        
+        let reader = try self.dequeueReader()
+        defer { self.enqueue(reader) }
+        
+        return try block(reader)
+    }
+}
+
+private extension ReadOnlyConnectionPool
+{
+    func dequeueReader() throws -> Reader
+    {
+        self.lock.lock()
+        
+        if let reader = self.idleReaders.popLast()
+        {
+            self.lock.unlock()
+            return reader
+        }
+        
+        self.lock.unlock()
+        
+        let reader = try self.makeReader()
+        return reader
+    }
+    
+    func enqueue(_ reader: Reader)
+    {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        self.idleReaders.append(reader)
+    }
+    
+    func makeReader() throws -> Reader
+    {
+        var components = URLComponents(url: self.fileURL, resolvingAgainstBaseURL: false)!
+        components.queryItems = [URLQueryItem(name: "mode", value: "ro")]
+        
+        if self.isImmutable
+        {
+            components.queryItems?.append(URLQueryItem(name: "immutable", value: "1"))
+        }
+        
+        let uri = components.url?.absoluteString ?? self.fileURL.path
+        
+        let connection = try Connection(.uri(uri), readonly: true)
+        try connection.execute("PRAGMA query_only = 1; PRAGMA mmap_size = \(ReadOnlyConnectionPool.mmapSize);")
+        
+        let reader = Reader(connection: connection, statementCache: StatementCache(connection))
+        return reader
+    }
+}
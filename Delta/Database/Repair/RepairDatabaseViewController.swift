@@ -254,7 +254,7 @@ private extension RepairDatabaseViewController
         }
         
         // Ignore error if we can't hash file, not that big a deal.
-        let hash = try? RSTHasher.sha1HashOfFile(at: expectedGame.gameSaveURL)
+        let hash = try? FileFingerprintCache.shared.sha1Hash(ofItemAt: expectedGame.gameSaveURL)
         
         // Make changes on separate context so we don't change any relationships until we're finished.
         // This allows us to refer to previous relationships.
@@ -0,0 +1,248 @@
+//
+//  SaveStateBlobStore.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Content-addressed storage for save state files, shared by every save state slot.
+//
+// Each unique save state is stored once in directoryURL as <sha256>, and every SaveState.fileURL with the same contents is a hard link to that blob.
+// This means existing code (DeltaCore, Harmony, exporting) keeps reading SaveState.fileURL unchanged, copying a slot is just creating another link,
+// and a blob's reference count is simply its link count, so there's no separate bookkeeping that could fall out of sync with Core Data.
+//
+// Because links share contents, save state files must always be replaced (e.g. remove + move, or rename) and never modified in place.
+// Blobs are read-only to enforce this, so writing to a save state file in place fails instead of silently changing every slot sharing its blob.
+//
+// Deduplication is local only: Harmony still uploads each SaveState's file separately, and replaces files it downloads with unlinked copies.
+// relinkItems(at:) links those copies back to their blobs once syncing finishes.
+final class SaveStateBlobStore
+{
+    struct Statistics
+    {
+        var blobCount = 0
+        var referenceCount = 0
+        
+        var totalSize: Int64 = 0
+        
+        // Bytes we would have used storing duplicate save states separately.
+        var deduplicatedSize: Int64 = 0
+    }
+    
+    let directoryURL: URL
+    
+    private var isCollectionScheduled = false
+    
+    private let lock = NSLock()
+    
+    init(directoryURL: URL)
+    {
+        self.directoryURL = directoryURL
+    }
+}
+
+extension SaveStateBlobStore
+{
+    /// Stores the contents of `sourceURL` as a blob (unless an identical blob already exists), then replaces `destinationURL` with a link to it.
+    ///
+    /// If `move` is true, `sourceURL` is consumed. `sourceURL` and `destinationURL` may be the same file, which deduplicates it in place.
+    ///
+    /// `destinationURL` is atomically replaced, never opened for writing, and is read-only afterwards.
+    /// Callers must also only ever replace it (e.g. by calling this method again), since writing to it in place would change every slot sharing its blob.
+    func storeItem(at sourceURL: URL, to destinationURL: URL, move: Bool) throws
+    {
+        try self.storeItem(at: sourceURL, to: destinationURL, move: move, replacingFileNumber: nil)
+    }
+    
+    /// Links save state files replaced outside SaveStateBlobStore (e.g. downloaded by Harmony) back to their blobs.
+    ///
+    /// Files already linked to a blob are skipped without hashing them, so this is cheap to call with every save state.
+    func relinkItems(at fileURLs: [URL])
+    {
+        for fileURL in fileURLs
+        {
+            guard let attributes = try? FileManager.default.attributesOfItem(atPath: fileURL.path) else { continue }
+            
+            let linkCount = (attributes[.referenceCount] as? NSNumber)?.intValue ?? 1
+            guard linkCount == 1 else { continue }
+            
+            // Hash our own link to the file, so we store exactly what we hashed even if fileURL is replaced in the meantime.
+            let snapshotURL = self.directoryURL.appendingPathComponent("." + UUID().uuidString)
+            defer { try? FileManager.default.removeItem(at: snapshotURL) }
+            
+            do
+            {
+                try FileManager.default.linkItem(at: fileURL, to: snapshotURL)
+                guard let fileNumber = self.fileNumber(ofItemAt: snapshotURL) else { continue }
+                
+                try self.storeItem(at: snapshotURL, to: fileURL, move: true, replacingFileNumber: fileNumber)
+            }
+            catch
+            {
+                Logger.database.error("Failed to relink save state \(fileURL.lastPathComponent, privacy: .public). \(error.localizedDescription, privacy: .public)")
+            }
+        }
+    }
+    
+    /// Removes `fileURL`, then removes its blob later if no other save states reference it.
+    func removeItem(at fileURL: URL) throws
+    {
+        try FileManager.default.removeItem(at: fileURL)
+        
+        // Deleting a game deletes all its save states at once, so coalesce collecting blobs.
+        let shouldSchedule = self.lock.withLock {
+            guard !self.isCollectionScheduled else { return false }
+            self.isCollectionScheduled = true
+            return true
+        }
+        
+        guard shouldSchedule else { return }
+        
+        DispatchQueue.global(qos: .utility).asyncAfter(deadline: .now() + 1.0) {
+            self.lock.withLock { self.isCollectionScheduled = false }
+            self.removeUnreferencedBlobs()
+        }
+    }
+    
+    /// Removes all blobs no longer linked from any save state, and returns statistics for the remaining blobs.
+    @discardableResult
+    func removeUnreferencedBlobs() -> Statistics
+    {
+        var statistics = Statistics()
+        
+        guard let blobURLs = try? FileManager.default.contentsOfDirectory(at: self.directoryURL, includingPropertiesForKeys: nil, options: .skipsHiddenFiles) else { return statistics }
+        
+        for blobURL in blobURLs
+        {
+            do
+            {
+                // Hold lock so we never remove a blob storeItem() is about to link.
+                try self.lock.withLock {
+                    let attributes = try FileManager.default.attributesOfItem(atPath: blobURL.path)
+                    
+                    let linkCount = (attributes[.referenceCount] as? NSNumber)?.intValue ?? 1
+                    let size = (attributes[.size] as? NSNumber)?.int64Value ?? 0
+                    
+                    if linkCount <= 1
+                    {
+                        try FileManager.default.removeItem(at: blobURL)
+                    }
+                    else
+                    {
+                        let referenceCount = linkCount - 1
+                        
+                        statistics.blobCount += 1
+                        statistics.referenceCount += referenceCount
+                        statistics.totalSize += size
+                        statistics.deduplicatedSize += size * Int64(referenceCount - 1)
+                        
+                        if let permissions = (attributes[.posixPermissions] as? NSNumber)?.int16Value, permissions != SaveStateBlobStore.blobPermissions
+                        {
+                            // Blobs stored before they were made read-only.
+                            try FileManager.default.setAttributes([.posixPermissions: SaveStateBlobStore.blobPermissions], ofItemAtPath: blobURL.path)
+                        }
+                    }
+                }
+            }
+            catch
+            {
+                Logger.database.error("Failed to remove save state blob \(blobURL.lastPathComponent, privacy: .public). \(error.localizedDescription, privacy: .public)")
+            }
+        }
+        
+        return statistics
+    }
+}
+
+private extension SaveStateBlobStore
+{
+    static let blobPermissions: Int16 = 0o444
+    
+    // If replacingFileNumber is non-nil, destinationURL is only replaced if it is still that file.
+    func storeItem(at sourceURL: URL, to destinationURL: URL, move: Bool, replacingFileNumber: UInt64?) throws
+    {
+        let hash = try FileManager.default.sha256Hash(ofItemAt: sourceURL)
+        let blobURL = self.directoryURL.appendingPathComponent(hash)
+        
+        try self.lock.withLock {
+            if let replacingFileNumber, self.fileNumber(ofItemAt: destinationURL) != replacingFileNumber
+            {
+                // destinationURL was replaced since we hashed it, so leave the newer file alone.
+                return
+            }
+            
+            if !FileManager.default.fileExists(atPath: blobURL.path)
+            {
+                // Write to a hidden file first so a blob never exists until it's complete.
+                let temporaryURL = self.directoryURL.appendingPathComponent("." + UUID().uuidString)
+                defer { try? FileManager.default.removeItem(at: temporaryURL) }
+                
+                if move
+                {
+                    do
+                    {
+                        // Source is being consumed anyway, so adopt it without copying.
+                        try FileManager.default.linkItem(at: sourceURL, to: temporaryURL)
+                    }
+                    catch
+                    {
+                        // Hard links can't span volumes.
+                        try FileManager.default.copyItem(at: sourceURL, to: temporaryURL)
+                    }
+                }
+                else
+                {
+                    // Clones on APFS, so still cheap.
+                    try FileManager.default.copyItem(at: sourceURL, to: temporaryURL)
+                }
+                
+                try FileManager.default.setAttributes([.posixPermissions: SaveStateBlobStore.blobPermissions], ofItemAtPath: temporaryURL.path)
+                try FileManager.default.moveItem(at: temporaryURL, to: blobURL)
+            }
+            
+            try self.link(blobURL, to: destinationURL)
+        }
+        
+        if move && sourceURL.standardizedFileURL != destinationURL.standardizedFileURL
+        {
+            try FileManager.default.removeItem(at: sourceURL)
+        }
+    }
+    
+    // Must be called while holding lock.
+    func link(_ blobURL: URL, to destinationURL: URL) throws
+    {
+        if let fileNumber = self.fileNumber(ofItemAt: blobURL), fileNumber == self.fileNumber(ofItemAt: destinationURL)
+        {
+            // Already linked to this blob.
+            return
+        }
+        
+        let temporaryURL = destinationURL.deletingLastPathComponent().appendingPathComponent("." + UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: temporaryURL) }
+        
+        do
+        {
+            try FileManager.default.linkItem(at: blobURL, to: temporaryURL)
+        }
+        catch
+        {
+            Logger.database.error("Failed to link save state blob \(blobURL.lastPathComponent, privacy: .public), copying instead. \(error.localizedDescription, privacy: .public)")
+            try FileManager.default.copyItem(at: blobURL, to: temporaryURL)
+        }
+        
+        // rename() atomically replaces any existing file, so destinationURL is never missing or partially written.
+        guard rename(temporaryURL.path, destinationURL.path) == 0 else { throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO) }
+    }
+    
+    func fileNumber(ofItemAt fileURL: URL) -> UInt64?
+    {
+        guard let attributes = try? FileManager.default.attributesOfItem(atPath: fileURL.path) else { return nil }
+        
+        let fileNumber = (attributes[.systemFileNumber] as? NSNumber)?.uint64Value
+        return fileNumber
+    }
+}
@@ -61,6 +61,7 @@ extension DeepLink
         case scene
         case game
         case saveState
+        case progress
         case error
     }
     
@@ -85,6 +85,9 @@ private extension DeepLinkController
             if let userActivity, userActivity.activityType == NSUserActivity.playGameActivityType,
                let isSaveStateAvailable = userActivity.userInfo?[NSUserActivity.isSaveStateAvailable] as? Bool, isSaveStateAvailable
             {
+                let progress = Progress(totalUnitCount: 0)
+                userInfo[.progress] = progress
+                
                 NotificationCenter.default.post(name: .deepLinkControllerWillLaunchGame, object: self, userInfo: userInfo)
                 
                 let gameType = game.type
@@ -92,24 +95,21 @@ private extension DeepLinkController
                 Task<Void, Never> { [userInfo] in
                     var userInfo = userInfo
                     
+                    let temporaryURL = FileManager.default.uniqueTemporaryURL()
+                    
                     do
                     {
-                        let (inputStream, outputStream) = try await userActivity.continuationStreams()
-                        inputStream.open()
-                        outputStream.open()
-                        
-                        let data: Data = try await inputStream.receive()
-                        
-                        let temporaryURL = FileManager.default.uniqueTemporaryURL()
-                        try data.write(to: temporaryURL, options: .atomic)
+                        try await self.receiveSaveState(from: userActivity, to: temporaryURL, progress: progress)
                         
                         let saveState = DeltaCore.SaveState(fileURL: temporaryURL, gameType: gameType)
                         userInfo[.saveState] = saveState
                     }
                     catch
                     {
-                        Logger.main.error("Failed to retrieve streams for Handoff. \(error.localizedDescription, privacy: .public)")
+                        Logger.main.error("Failed to receive save state for Handoff. \(error.localizedDescription, privacy: .public)")
                         userInfo[.error] = error
+                        
+                        try? FileManager.default.removeItem(at: temporaryURL)
                     }
                     
                     await MainActor.run { [userInfo] in
@@ -132,3 +132,53 @@ private extension DeepLinkController
         return true
     }
 }
+
+private extension DeepLinkController
+{
+    static let maximumHandoffAttempts = 3
+    
+    func receiveSaveState(from userActivity: NSUserActivity, to fileURL: URL, progress: Progress) async throws
+    {
+        // Reused for every attempt so sender can resume sending the same save state.
+        let transferID = UUID()
+        
+        var offset = 0
+        var attempt = 1
+        
+        while true
+        {
+            do
+            {
+                // Handoff doesn't document whether continuation streams can be requested more than once.
+                // If they can't, this throws and we give up, same as if every attempt was interrupted.
+                let (inputStream, outputStream) = try await userActivity.continuationStreams()
+                inputStream.open()
+                outputStream.open()
+                
+                defer {
+                    inputStream.close()
+                    outputStream.close()
+                }
+                
+                let request = HandoffSaveStateRequest(supportsChunks: true, supportsCompression: true, transferID: transferID, offset: offset)
+                try await outputStream.send(request)
+                
+                // Streams chunks directly to disk (or falls back to legacy format if sender doesn't support chunks).
+                try await inputStream.receiveFile(to: fileURL, offset: offset, progress: progress)
+                return
+            }
+            catch
+            {
+                guard attempt < DeepLinkController.maximumHandoffAttempts else { throw error }
+                
+                // fileURL only contains verified chunks, so resume from however much we received.
+                offset = (try? fileURL.resourceValues(forKeys: [.fileSizeKey]).fileSize) ?? 0
+                attempt += 1
+                
+                Logger.main.error("Handoff transfer interrupted after \(offset) bytes, retrying... \(error.localizedDescription, privacy: .public)")
+                
+                try await Task.sleep(nanoseconds: 500 * NSEC_PER_MSEC)
+            }
+        }
+    }
+}
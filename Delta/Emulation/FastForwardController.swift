@@ -0,0 +1,158 @@
+//
+//  FastForwardController.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+// Adaptively fast forwards by measuring how many frames are actually emulated per second,
+// then ramping EmulatorCore.rate up towards the requested speed for as long as the device keeps up.
+final class FastForwardController: FrameObserving
+{
+    struct Statistics
+    {
+        var requestedRate: Double
+        var currentRate: Double
+        
+        // Speed actually achieved over most recent measurement window.
+        var achievedRate: Double = 0
+        
+        // Highest rate that was fully sustained for an entire measurement window.
+        var maximumSustainedRate: Double = 0
+    }
+    
+    static let measurementInterval: TimeInterval = 0.5
+    static let rampStep: Double = 0.5
+    
+    let emulatorCore: EmulatorCore
+    
+    var isActive: Bool {
+        return self.lock.withLock { self._statistics != nil }
+    }
+    
+    var statistics: Statistics? {
+        return self.lock.withLock { self._statistics }
+    }
+    private var _statistics: Statistics?
+    
+    private var windowStartTime: UInt64 = 0
+    private var windowFrameCount = 0
+    
+    // Rate that most recently failed to sustain, so we don't immediately ramp back up to it.
+    private var failedRate: Double?
+    private var failedRateExpiration: UInt64 = 0
+    
+    private let lock = NSLock()
+    
+    init(emulatorCore: EmulatorCore)
+    {
+        self.emulatorCore = emulatorCore
+    }
+    
+    // Starts at a conservative speed, then ramps up to requestedRate if sustainable.
+    func start(requestedRate: Double)
+    {
+        let initialRate = min(requestedRate, 2.0)
+        
+        self.lock.withLock {
+            self._statistics = Statistics(requestedRate: requestedRate, currentRate: initialRate)
+            self.failedRate = nil
+            self.resetWindow()
+        }
+        
+        self.emulatorCore.rate = initialRate
+    }
+    
+    @discardableResult
+    func stop() -> Statistics?
+    {
+        let statistics = self.lock.withLock {
+            let statistics = self._statistics
+            self._statistics = nil
+            return statistics
+        }
+        
+        self.emulatorCore.rate = self.emulatorCore.deltaCore.supportedRates.lowerBound
+        return statistics
+    }
+    
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+    {
+        self.didEmulateFrame()
+    }
+}
+
+private extension FastForwardController
+{
+    func didEmulateFrame()
+    {
+        var updatedRate: Double?
+        
+        self.lock.withLock {
+            guard var statistics = self._statistics else { return }
+            
+            let now = DispatchTime.now().uptimeNanoseconds
+            self.windowFrameCount += 1
+            
+            let elapsedTime = TimeInterval(now - self.windowStartTime) / TimeInterval(NSEC_PER_SEC)
+            guard elapsedTime >= FastForwardController.measurementInterval else { return }
+            
+            defer { self.resetWindow() }
+            
+            // Ignore windows that include pauses (e.g. pause menu), since they don't reflect emulation speed.
+            guard elapsedTime < FastForwardController.measurementInterval * 2, self.emulatorCore.rate == statistics.currentRate else { return }
+            
+            let frameDuration = self.emulatorCore.deltaCore.emulatorBridge.frameDuration
+            statistics.achievedRate = Double(self.windowFrameCount) * frameDuration / elapsedTime
+            
+            if statistics.achievedRate >= statistics.currentRate * 0.95
+            {
+                statistics.maximumSustainedRate = max(statistics.currentRate, statistics.maximumSustainedRate)
+                
+                let nextRate = min(statistics.currentRate + FastForwardController.rampStep, statistics.requestedRate)
+                if let failedRate = self.failedRate, nextRate >= failedRate, now < self.failedRateExpiration
+                {
+                    // Recently failed to sustain nextRate, so wait a bit before trying again.
+                }
+                else if nextRate > statistics.currentRate
+                {
+                    statistics.currentRate = nextRate
+                    updatedRate = nextRate
+                }
+            }
+            else if statistics.achievedRate < statistics.currentRate * 0.85
+            {
+                // Can't keep up, so drop to the speed we actually achieved (rounded down to nearest quarter).
+                let sustainableRate = max((statistics.achievedRate * 4).rounded(.down) / 4, self.emulatorCore.deltaCore.supportedRates.lowerBound)
+                
+                self.failedRate = statistics.currentRate
+                self.failedRateExpiration = now + 5 * NSEC_PER_SEC
+                
+                statistics.currentRate = sustainableRate
+                updatedRate = sustainableRate
+            }
+            
+            self._statistics = statistics
+        }
+        
+        if let updatedRate
+        {
+            DispatchQueue.main.async {
+                guard self.statistics?.currentRate == updatedRate else { return }
+                self.emulatorCore.rate = updatedRate
+            }
+        }
+    }
+    
+    // Must be called while holding lock.
+    func resetWindow()
+    {
+        self.windowStartTime = DispatchTime.now().uptimeNanoseconds
+        self.windowFrameCount = 0
+    }
+}
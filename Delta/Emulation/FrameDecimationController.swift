@@ -0,0 +1,133 @@
+//
+//  FrameDecimationController.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import UIKit
+
+import DeltaCore
+
+// Skips rendering frames while fast forwarding that would never be visible anyway,
+// so more CPU + GPU time can be spent emulating instead.
+//
+// Emulation itself always runs at full rate; we only disable EmulatorCore.videoManager (via FrameHook) for frames that shouldn't be presented.
+// All game views (including AirPlay ones) share the same video manager, so they're all decimated together.
+final class FrameDecimationController: FrameObserving
+{
+    enum Policy
+    {
+        // Present every nth emulated frame.
+        case everyNthFrame(Int)
+        
+        // Present frames no faster than displayRefreshRate.
+        case displayRefreshRate
+    }
+    
+    struct Statistics
+    {
+        var presentedFrames = 0
+        var skippedFrames = 0
+    }
+    
+    let emulatorCore: EmulatorCore
+    let policy: Policy
+    
+    // Lowest refresh rate of all displays currently showing game (e.g. main screen + AirPlay display).
+    var displayRefreshRate: Double {
+        get { self.lock.withLock { self._displayRefreshRate } }
+        set { self.lock.withLock { self._displayRefreshRate = newValue } }
+    }
+    private var _displayRefreshRate: Double
+    
+    // Totals across all fast forward sessions for current game.
+    var statistics: Statistics {
+        return self.lock.withLock { self._statistics }
+    }
+    private var _statistics = Statistics()
+    
+    // Current fast forward session.
+    private var sessionStatistics = Statistics()
+    
+    private var frameIndex = 0
+    private var isSkippingFrames = false
+    
+    private let lock = NSLock()
+    
+    init(emulatorCore: EmulatorCore, policy: Policy, displayRefreshRate: Double)
+    {
+        self.emulatorCore = emulatorCore
+        self.policy = policy
+        self._displayRefreshRate = displayRefreshRate
+    }
+    
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+    {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        let rate = self.emulatorCore.rate
+        
+        guard rate > self.emulatorCore.deltaCore.supportedRates.lowerBound else {
+            if self.isSkippingFrames
+            {
+                // Restores video to whatever it was before we started skipping frames, rather than always enabling it.
+                frameHook.setVideoDisabled(false, by: self)
+                self.isSkippingFrames = false
+            }
+            
+            if self.sessionStatistics.presentedFrames + self.sessionStatistics.skippedFrames > 0
+            {
+                Logger.main.info("Fast forward presented \(self.sessionStatistics.presentedFrames) frame(s), skipped \(self.sessionStatistics.skippedFrames) frame(s).")
+                self.sessionStatistics = Statistics()
+            }
+            
+            self.frameIndex = 0
+            return
+        }
+        
+        // Record what happened to the frame we just emulated.
+        if self.isSkippingFrames
+        {
+            self.sessionStatistics.skippedFrames += 1
+            self._statistics.skippedFrames += 1
+        }
+        else if frameHook.didPresentFrame
+        {
+            self.sessionStatistics.presentedFrames += 1
+            self._statistics.presentedFrames += 1
+        }
+        
+        self.frameIndex += 1
+        
+        // Decide whether to render the next frame.
+        let interval = self.decimationInterval(rate: rate)
+        let shouldPresentNextFrame = (self.frameIndex % interval == 0)
+        
+        if shouldPresentNextFrame == self.isSkippingFrames
+        {
+            frameHook.setVideoDisabled(!shouldPresentNextFrame, by: self)
+            self.isSkippingFrames = !shouldPresentNextFrame
+        }
+    }
+}
+
+private extension FrameDecimationController
+{
+    // Must be called while holding lock.
+    func decimationInterval(rate: Double) -> Int
+    {
+        switch self.policy
+        {
+        case .everyNthFrame(let interval): return max(interval, 1)
+        case .displayRefreshRate:
+            let framesPerSecond = rate / self.emulatorCore.deltaCore.emulatorBridge.frameDuration
+            guard self._displayRefreshRate > 0 else { return 1 }
+            
+            let interval = Int((framesPerSecond / self._displayRefreshRate).rounded(.up))
+            return max(interval, 1)
+        }
+    }
+}
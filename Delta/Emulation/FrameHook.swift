@@ -0,0 +1,178 @@
+//
+//  FrameHook.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+protocol FrameObserving: AnyObject
+{
+    // Called on emulation thread after every emulated frame.
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+}
+
+// Installs a single EmulatorCore.updateHandler that forwards every frame to observers, and restores the original handler when deallocated.
+//
+// Others (e.g. AchievementsTracker) may wrap updateHandler after us, so a FrameHook should live as long as its emulatorCore.
+// Change observers rather than creating a new FrameHook.
+//
+// Also arbitrates EmulatorCore.videoManager.isEnabled between observers, so one observer never re-enables video another observer disabled.
+final class FrameHook
+{
+    let emulatorCore: EmulatorCore
+    
+    // Called in order after every frame. Once set, removed observers are no longer called and any video they disabled is restored.
+    var observers: [FrameObserving] {
+        get { self.lock.withLock { self._observers } }
+        set {
+            let removedObservers = self.lock.withLock {
+                let removedObservers = self._observers.filter { observer in !newValue.contains { $0 === observer } }
+                self._observers = newValue
+                return removedObservers
+            }
+            
+            // Wait for current frame to finish, since it may still be calling removed observers.
+            self.dispatchLock.withLock {}
+            
+            for observer in removedObservers
+            {
+                self.setVideoDisabled(false, by: observer)
+            }
+        }
+    }
+    private var _observers = [FrameObserving]()
+    
+    // Whether current frame was displayed. Only valid while observers are being called.
+    var didPresentFrame: Bool {
+        return self.lock.withLock { self._didPresentFrame }
+    }
+    private var _didPresentFrame = false
+    
+    private let originalUpdateHandler: ((EmulatorCore) -> Void)?
+    
+    // Observers that currently need video disabled, and whether video should be enabled once they're all done.
+    private var videoDisablingObservers = Set<ObjectIdentifier>()
+    private var isVideoEnabledWhenRestored = true
+    
+    private let lock = NSLock()
+    
+    // Recursive so frames emulated by observers (e.g. run-ahead) that call updateHandler don't deadlock.
+    private let dispatchLock = NSRecursiveLock()
+    private var isDispatchingFrame = false // Only accessed while holding dispatchLock.
+    
+    init(emulatorCore: EmulatorCore)
+    {
+        self.emulatorCore = emulatorCore
+        self.originalUpdateHandler = emulatorCore.updateHandler
+        
+        let originalUpdateHandler = self.originalUpdateHandler
+        self.emulatorCore.updateHandler = { [weak self] emulatorCore in
+            originalUpdateHandler?(emulatorCore)
+            self?.didEmulateFrame()
+        }
+    }
+    
+    deinit
+    {
+        self.emulatorCore.updateHandler = self.originalUpdateHandler
+        
+        if !self.videoDisablingObservers.isEmpty
+        {
+            self.emulatorCore.videoManager.isEnabled = self.isVideoEnabledWhenRestored
+        }
+    }
+}
+
+extension FrameHook
+{
+    // Disables video until every observer that disabled it re-enables it, then restores whatever it was beforehand.
+    func setVideoDisabled(_ isDisabled: Bool, by observer: FrameObserving)
+    {
+        let identifier = ObjectIdentifier(observer)
+        let videoManager = self.emulatorCore.videoManager
+        
+        self.lock.withLock {
+            if isDisabled
+            {
+                if videoManager.isEnabled
+                {
+                    // Either no one has disabled video yet, or something else (e.g. SaveStatesViewController) re-enabled it since.
+                    self.isVideoEnabledWhenRestored = true
+                    videoManager.isEnabled = false
+                }
+                else if self.videoDisablingObservers.isEmpty
+                {
+                    // Video was already disabled by someone other than an observer, so leave it disabled afterwards.
+                    self.isVideoEnabledWhenRestored = false
+                }
+                
+                self.videoDisablingObservers.insert(identifier)
+            }
+            else
+            {
+                guard self.videoDisablingObservers.remove(identifier) != nil, self.videoDisablingObservers.isEmpty else { return }
+                videoManager.isEnabled = self.isVideoEnabledWhenRestored
+            }
+        }
+    }
+    
+    // Calls `body` with video temporarily enabled if observer's own request is the only reason video is disabled.
+    // Used to display frames emulated outside the normal game loop (e.g. run-ahead).
+    func presentFrame(by observer: FrameObserving, _ body: (_ processVideo: Bool) -> Void)
+    {
+        let identifier = ObjectIdentifier(observer)
+        let videoManager = self.emulatorCore.videoManager
+        
+        let shouldPresentFrame = self.lock.withLock {
+            let shouldPresentFrame = (self.videoDisablingObservers == [identifier] && self.isVideoEnabledWhenRestored)
+            
+            if shouldPresentFrame
+            {
+                videoManager.isEnabled = true
+            }
+            
+            return shouldPresentFrame
+        }
+        
+        // Must not hold lock, since emulating a frame may call updateHandler (and therefore didEmulateFrame()).
+        body(shouldPresentFrame)
+        
+        guard shouldPresentFrame else { return }
+        
+        self.lock.withLock {
+            videoManager.isEnabled = false
+            self._didPresentFrame = true
+        }
+    }
+}
+
+private extension FrameHook
+{
+    func didEmulateFrame()
+    {
+        self.dispatchLock.lock()
+        defer { self.dispatchLock.unlock() }
+        
+        // Frames emulated by observers themselves aren't real frames, so don't notify observers about them.
+        guard !self.isDispatchingFrame else { return }
+        
+        self.isDispatchingFrame = true
+        defer { self.isDispatchingFrame = false }
+        
+        let observers = self.lock.withLock {
+            // Video state hasn't changed since emulating frame, so this is whether it was rendered.
+            self._didPresentFrame = self.emulatorCore.videoManager.isEnabled
+            return self._observers
+        }
+        
+        for observer in observers
+        {
+            observer.frameHook(self, didEmulateFrameOf: self.emulatorCore)
+        }
+    }
+}
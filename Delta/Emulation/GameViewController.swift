@@ -32,6 +32,39 @@ private extension DeltaCore.ControllerSkin
 
 private extension GameViewController
 {
+    // Everything we need from the emulator core to finish saving a save state after resuming emulation.
+    struct CapturedSaveState
+    {
+        var fileURL: URL
+        var isTemporary: Bool // If true, fileURL is moved (rather than copied) to the save state's location.
+        
+        var snapshot: UIImage?
+        
+        var coreIdentifier: String?
+        var coreVersion: String?
+        
+        // How long emulation was paused while capturing save state.
+        var pauseDuration: TimeInterval
+        
+        // If non-nil, core may still be writing to fileURL until at least this date.
+        var flushDeadline: Date?
+    }
+    
+    // Tracks how long capturing save states stalls emulation.
+    struct SaveStateCaptureStatistics
+    {
+        var captureCount = 0
+        
+        var lastPauseDuration: TimeInterval = 0
+        var maximumPauseDuration: TimeInterval = 0
+        var totalPauseDuration: TimeInterval = 0
+        
+        var averagePauseDuration: TimeInterval {
+            guard self.captureCount > 0 else { return 0 }
+            return self.totalPauseDuration / TimeInterval(self.captureCount)
+        }
+    }
+    
     struct PausedSaveState: SaveStateProtocol
     {
         var fileURL: URL
@@ -110,6 +143,7 @@ class GameViewController: DeltaCore.GameViewController
             if oldValue?.fileURL != game?.fileURL
             {
                 self.shouldResetSustainedInputs = true
+                self.handoffTransfer = nil
             }
             
             self.updateControllers()
@@ -118,6 +152,11 @@ class GameViewController: DeltaCore.GameViewController
             self.presentedGyroAlert = false
             
             self.startTrackingAchievements()
+            self.updateRunAhead()
+            self.updateRewind()
+            self.updatePerformanceHUD()
+            self.updateFrameDecimation()
+            self.updateAutoSaveCheckpoints()
         }
     }
     
@@ -165,6 +204,16 @@ class GameViewController: DeltaCore.GameViewController
     
     private var _isLoadingSaveState = false
     
+    // Minimum time to wait before reading save states from cores that write them asynchronously.
+    private static let saveStateFlushDuration: TimeInterval = 0.5
+    
+    // Serial so writes to the same save state (e.g. repeated quick saves) finish in order.
+    private let saveStateQueue = DispatchQueue(label: "com.rileytestut.Delta.GameViewController.saveStateQueue", qos: .userInitiated)
+    private var autoSaveCheckpointTimer: Timer?
+    
+    // Only accessed on main thread, where save states are captured.
+    private(set) var saveStateCaptureStatistics = SaveStateCaptureStatistics()
+    
     // Online Multiplayer
     private var onlineConnectionDate: Date?
     private var onlineBackgroundTaskID: UIBackgroundTaskIdentifier?
@@ -172,6 +221,23 @@ class GameViewController: DeltaCore.GameViewController
     // Handoff
     private var isContinuingHandoff = false
     private var handoffPlaceholderView: RSTPlaceholderView!
+    private var handoffProgressObservation: NSKeyValueObservation?
+    
+    // Most recent save state sent via Handoff, kept until transfer succeeds in case receiving device retries.
+    private var handoffTransfer: (id: UUID, fileURL: URL)? {
+        didSet {
+            guard let transfer = oldValue, transfer.fileURL != self.handoffTransfer?.fileURL else { return }
+            
+            do
+            {
+                try FileManager.default.removeItem(at: transfer.fileURL)
+            }
+            catch
+            {
+                print(error)
+            }
+        }
+    }
     
     // Gestures
     private var isMenuButtonHeldDown = false
@@ -197,6 +263,15 @@ class GameViewController: DeltaCore.GameViewController
     private var achievementsTracker: AchievementsTracker?
     private var isPreparingAchievements = false
     
+    private var frameHook: FrameHook?
+    
+    private var runAheadController: RunAheadController?
+    private var rewindController: RewindController?
+    private var fastForwardController: FastForwardController?
+    private var frameDecimationController: FrameDecimationController?
+    
+    private var performanceHUDView: UIView? // PerformanceHUDView, which requires iOS 18.
+    
     override var shouldAutorotate: Bool {
         return !self.isGyroActive
     }
@@ -317,6 +392,7 @@ class GameViewController: DeltaCore.GameViewController
             case .fastForward: self.performFastForwardAction(activate: true)
             case .reverseScreens: self.performReverseScreensAction()
             case .screenshot: self.performScreenshotAction()
+            case .rewind: self.performRewindAction(activate: true)
             case .toggleFastForward:
                 let isFastForwarding = (emulatorCore.rate != emulatorCore.deltaCore.supportedRates.lowerBound)
                 self.performFastForwardAction(activate: !isFastForwarding)
@@ -370,6 +446,7 @@ class GameViewController: DeltaCore.GameViewController
             case .toggleFastForward: break
             case .reverseScreens: break
             case .screenshot: break
+            case .rewind: self.performRewindAction(activate: false)
             }
         }
     }
@@ -703,13 +780,15 @@ extension GameViewController
             
             do
             {
-                try emulatorCore.load(saveState)
+                try emulatorCore.loadSaveState(saveState)
             }
             catch
             {
                 print(error)
             }
             
+            self.rewindController?.reset()
+            
             _deepLinkResumingSaveState = nil
             emulatorCore.resume()
         }
@@ -1035,7 +1114,8 @@ private extension GameViewController
             {
                 let game = context.object(with: game.objectID) as! Game
                 
-                let hash = try RSTHasher.sha1HashOfFile(at: game.gameSaveURL)
+                // Only rehashes save file if it's been modified since last time.
+                let hash = try FileFingerprintCache.shared.sha1Hash(ofItemAt: game.gameSaveURL)
                 let previousHash = game.gameSave?.sha1
                 
                 guard hash != previousHash else { return }
@@ -1091,49 +1171,125 @@ extension GameViewController: SaveStatesViewControllerDelegate
         
         self.pausedSaveState?.isSaved = true
         
+        let capturedSaveState = self.captureSaveState(replacing: self.pausedSaveState)
+        
         // Must be done synchronously
+        self.saveStateQueue.sync {
+            self.insertAutoSaveState(capturedSaveState, forGameWithID: game.objectID)
+        }
+    }
+    
+    // Auto save states form a ring of slots per game: once every slot is used, the least recently saved one is replaced.
+    private func insertAutoSaveState(_ capturedSaveState: CapturedSaveState, forGameWithID gameID: NSManagedObjectID)
+    {
+        let slotCount = ExperimentalFeatures.shared.autoSaveCheckpoints.isEnabled ? Int(ExperimentalFeatures.shared.autoSaveCheckpoints.slotCount) : 2
+        
         let backgroundContext = DatabaseManager.shared.newBackgroundContext()
         backgroundContext.performAndWait {
             
-            let game = backgroundContext.object(with: game.objectID) as! Game
+            let game = backgroundContext.object(with: gameID) as! Game
             
             let fetchRequest = SaveState.fetchRequest(for: game, type: .auto)
-            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.creationDate), ascending: true)]
+            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.modifiedDate), ascending: true)]
             
             do
             {
                 let saveStates = try fetchRequest.execute()
                 
-                if let saveState = saveStates.first, saveStates.count >= 2
+                // Only delete save states if slot count was lowered since last auto save.
+                let excessCount = max(saveStates.count - slotCount, 0)
+                for saveState in saveStates.prefix(excessCount)
                 {
-                    // If there are two or more auto save states, update the oldest one
-                    self.update(saveState, with: self.pausedSaveState)
-                    
-                    // Tiny hack: SaveStatesViewController sorts save states by creation date, so we update the creation date too
-                    // Simpler than deleting old save states ¯\_(ツ)_/¯
-                    saveState.creationDate = saveState.modifiedDate
+                    backgroundContext.delete(saveState)
+                }
+                
+                let saveState: SaveState
+                
+                if let oldestSaveState = saveStates.dropFirst(excessCount).first, saveStates.count - excessCount >= slotCount
+                {
+                    // Update least recently saved one in place, so syncing uploads a single change instead of an insertion + deletion.
+                    saveState = oldestSaveState
                 }
                 else
                 {
-                    // Otherwise, create a new one
-                    let saveState = SaveState.insertIntoManagedObjectContext(backgroundContext)
+                    saveState = SaveState(context: backgroundContext)
                     saveState.type = .auto
                     saveState.game = game
-                    
-                    self.update(saveState, with: self.pausedSaveState)
                 }
+                
+                self.write(capturedSaveState, to: saveState)
+                
+                saveState.modifiedDate = Date()
+                saveState.coreIdentifier = capturedSaveState.coreIdentifier
+                saveState.coreVersion = capturedSaveState.coreVersion
+                
+                // SaveStatesViewController sorts save states by creation date, so we update the creation date too.
+                saveState.creationDate = saveState.modifiedDate
             }
             catch
             {
                 print(error)
             }
-
+            
             backgroundContext.saveWithErrorLogging()
         }
     }
     
+    func updateAutoSaveCheckpoints()
+    {
+        self.autoSaveCheckpointTimer?.invalidate()
+        self.autoSaveCheckpointTimer = nil
+        
+        guard self.game != nil, ExperimentalFeatures.shared.autoSaveCheckpoints.isEnabled else { return }
+        
+        let interval = ExperimentalFeatures.shared.autoSaveCheckpoints.checkpointInterval * 60
+        
+        let timer = Timer(timeInterval: interval, repeats: true) { [weak self] _ in
+            self?.checkpointAutoSaveState()
+        }
+        timer.tolerance = interval * 0.1
+        RunLoop.main.add(timer, forMode: .common)
+        
+        self.autoSaveCheckpointTimer = timer
+    }
+    
+    // Auto saves in background while playing, so if we quit unexpectedly we lose at most one checkpoint interval of progress.
+    private func checkpointAutoSaveState()
+    {
+        // Pausing already updates auto save state, so only checkpoint while running.
+        guard let game = self.game as? Game, let emulatorCore = self.emulatorCore, emulatorCore.state == .running, !emulatorCore.isWirelessMultiplayerActive else { return }
+        
+        // Serializes core state once, then writes + updates database on saveStateQueue without blocking emulation.
+        let capturedSaveState = self.captureSaveState()
+        let gameID = game.objectID
+        
+        self.saveStateQueue.async {
+            self.insertAutoSaveState(capturedSaveState, forGameWithID: gameID)
+        }
+    }
+    
     private func update(_ saveState: SaveState, with replacementSaveState: SaveStateProtocol? = nil)
     {
+        let capturedSaveState = self.captureSaveState(replacing: replacementSaveState)
+        self.write(capturedSaveState, to: saveState)
+        
+        saveState.modifiedDate = Date()
+        saveState.coreIdentifier = capturedSaveState.coreIdentifier
+        saveState.coreVersion = capturedSaveState.coreVersion
+        
+        if ExperimentalFeatures.shared.toastNotifications.stateSaveEnabled,
+           saveState.type != .auto
+        {
+            self.presentExperimentalToastView(NSLocalizedString("Saved Save State", comment: ""))
+        }
+    }
+    
+    // Pauses emulation only long enough to serialize the core's state + snapshot the current frame.
+    // Remaining file I/O and PNG encoding are done in write(_:to:), which is safe to call from any thread.
+    private func captureSaveState(replacing replacementSaveState: SaveStateProtocol? = nil) -> CapturedSaveState
+    {
+        let startTime = CACurrentMediaTime()
+        
         let isRunning = (self.emulatorCore?.state == .running)
         
         if isRunning
@@ -1141,29 +1297,87 @@ extension GameViewController: SaveStatesViewControllerDelegate
             self.pauseEmulation()
         }
         
+        let fileURL: URL
+        let isTemporary: Bool
+        var flushDeadline: Date?
+        
         if let replacementSaveState = replacementSaveState
         {
-            do
+            fileURL = replacementSaveState.fileURL
+            isTemporary = false
+        }
+        else
+        {
+            fileURL = FileManager.default.uniqueTemporaryURL()
+            isTemporary = true
+            
+            self.emulatorCore?.saveSaveState(to: fileURL)
+            
+            if let game = self.game, let system = System(gameType: game.type), system.writesSaveStatesAsynchronously
             {
-                if FileManager.default.fileExists(atPath: saveState.fileURL.path)
-                {
-                    // Don't use replaceItem(), since that removes the original file as well
-                    try FileManager.default.removeItem(at: saveState.fileURL)
-                }
+                flushDeadline = Date().addingTimeInterval(GameViewController.saveStateFlushDuration)
+            }
+        }
+        
+        let snapshot = self.emulatorCore?.videoManager.snapshot()
+        
+        let coreIdentifier = self.emulatorCore?.deltaCore.identifier
+        let coreVersion = self.emulatorCore?.deltaCore.version
+        
+        if isRunning
+        {
+            self.resumeEmulation()
+        }
+        
+        let pauseDuration = CACurrentMediaTime() - startTime
+        Logger.main.info("Paused emulation for \(pauseDuration * 1000, format: .fixed(precision: 2), privacy: .public)ms to capture save state.")
+        
+        self.saveStateCaptureStatistics.captureCount += 1
+        self.saveStateCaptureStatistics.lastPauseDuration = pauseDuration
+        self.saveStateCaptureStatistics.maximumPauseDuration = max(pauseDuration, self.saveStateCaptureStatistics.maximumPauseDuration)
+        self.saveStateCaptureStatistics.totalPauseDuration += pauseDuration
+        
+        let capturedSaveState = CapturedSaveState(fileURL: fileURL, isTemporary: isTemporary, snapshot: snapshot, coreIdentifier: coreIdentifier, coreVersion: coreVersion, pauseDuration: pauseDuration, flushDeadline: flushDeadline)
+        return capturedSaveState
+    }
+    
+    private func write(_ capturedSaveState: CapturedSaveState, to saveState: SaveStateProtocol)
+    {
+        defer {
+            if capturedSaveState.isTemporary
+            {
+                // Normally already consumed, but make sure it isn't leaked if writing failed.
+                try? FileManager.default.removeItem(at: capturedSaveState.fileURL)
+            }
+        }
+        
+        do
+        {
+            if let flushDeadline = capturedSaveState.flushDeadline
+            {
+                // Don't hash or move save state until core has finished writing it, or we'd store an incomplete file.
+                try self.waitForSaveStateFlush(at: capturedSaveState.fileURL, deadline: flushDeadline)
+            }
+            
+            if ExperimentalFeatures.shared.compressedSaveStates.isEnabled && capturedSaveState.isTemporary
+            {
+                // Compress directly from temporary file, which is no longer needed afterwards.
+                try SaveStateContainer.write(stateAt: capturedSaveState.fileURL, to: saveState.fileURL, coreIdentifier: capturedSaveState.coreIdentifier, coreVersion: capturedSaveState.coreVersion, snapshot: capturedSaveState.snapshot)
                 
-                try FileManager.default.copyItem(at: replacementSaveState.fileURL, to: saveState.fileURL)
+                try DatabaseManager.shared.saveStateBlobStore.storeItem(at: saveState.fileURL, to: saveState.fileURL, move: true)
             }
-            catch
+            else
             {
-                print(error)
+                // Identical save states (e.g. auto save state copied from pausedSaveState) share the same blob, so this is usually just a hard link.
+                try DatabaseManager.shared.saveStateBlobStore.storeItem(at: capturedSaveState.fileURL, to: saveState.fileURL, move: capturedSaveState.isTemporary)
             }
         }
-        else
+        catch
         {
-            self.emulatorCore?.saveSaveState(to: saveState.fileURL)
+            print(error)
         }
         
-        if let snapshot = self.emulatorCore?.videoManager.snapshot(), let data = snapshot.pngData()
+        if let snapshot = capturedSaveState.snapshot, let data = snapshot.pngData(), let saveState = saveState as? SaveState
         {
             do
             {
@@ -1174,20 +1388,32 @@ extension GameViewController: SaveStatesViewControllerDelegate
                 print(error)
             }
         }
-        
-        saveState.modifiedDate = Date()
-        saveState.coreIdentifier = self.emulatorCore?.deltaCore.identifier
-        saveState.coreVersion = self.emulatorCore?.deltaCore.version
-        
-        if ExperimentalFeatures.shared.toastNotifications.stateSaveEnabled,
-           saveState.type != .auto
+    }
+    
+    // Waits until deadline, then until file exists and its size stops changing.
+    private func waitForSaveStateFlush(at fileURL: URL, deadline: Date) throws
+    {
+        let remainingTime = deadline.timeIntervalSinceNow
+        if remainingTime > 0
         {
-            self.presentExperimentalToastView(NSLocalizedString("Saved Save State", comment: ""))
+            Thread.sleep(forTimeInterval: remainingTime)
         }
         
-        if isRunning
+        let timeoutDate = Date().addingTimeInterval(5.0)
+        var previousFileSize: Int?
+        
+        while true
         {
-            self.resumeEmulation()
+            let fileSize = try? fileURL.resourceValues(forKeys: [.fileSizeKey]).fileSize
+            if let fileSize, fileSize > 0, fileSize == previousFileSize
+            {
+                break
+            }
+            
+            guard Date() < timeoutDate else { throw CocoaError(.fileReadNoSuchFile, userInfo: [NSURLErrorKey: fileURL]) }
+            
+            previousFileSize = fileSize
+            Thread.sleep(forTimeInterval: 0.05)
         }
     }
     
@@ -1206,11 +1432,12 @@ extension GameViewController: SaveStatesViewControllerDelegate
         
         if let autoSaveState = saveState as? SaveState, autoSaveState.type == .auto
         {
-            let temporaryURL = FileManager.default.uniqueTemporaryURL()
+            // Hard link rather than copy, which is safe because updating auto save state replaces its file instead of writing to it.
+            let temporaryURL = saveState.fileURL.deletingLastPathComponent().appendingPathComponent("." + UUID().uuidString)
             
             do
             {
-                try FileManager.default.moveItem(at: saveState.fileURL, to: temporaryURL)
+                try FileManager.default.linkItem(at: saveState.fileURL, to: temporaryURL)
                 temporarySaveState = DeltaCore.SaveState(fileURL: temporaryURL, gameType: saveState.gameType)
             }
             catch
@@ -1225,12 +1452,12 @@ extension GameViewController: SaveStatesViewControllerDelegate
         {
             if let temporarySaveState = temporarySaveState
             {
-                try self.emulatorCore?.load(temporarySaveState)
+                try self.emulatorCore?.loadSaveState(temporarySaveState)
                 try FileManager.default.removeItem(at: temporarySaveState.fileURL)
             }
             else
             {
-                try self.emulatorCore?.load(saveState)
+                try self.emulatorCore?.loadSaveState(saveState)
             }
             
             if ExperimentalFeatures.shared.toastNotifications.stateLoadEnabled
@@ -1248,6 +1475,7 @@ extension GameViewController: SaveStatesViewControllerDelegate
         }
         
         self.achievementsTracker?.reset()
+        self.rewindController?.reset()
         
         if isRunning
         {
@@ -1368,33 +1596,51 @@ extension GameViewController
     {
         guard let game = self.game as? Game, let emulatorCore, !emulatorCore.isWirelessMultiplayerActive else { return }
         
-        let backgroundContext = DatabaseManager.shared.newBackgroundContext()
-        backgroundContext.performAndWait {
-            
-            let game = backgroundContext.object(with: game.objectID) as! Game
-            let fetchRequest = SaveState.fetchRequest(for: game, type: .quick)
-            
-            do
-            {
-                if let quickSaveState = try fetchRequest.execute().first
+        // Resume emulation as soon as core state has been captured, then finish saving in background.
+        let capturedSaveState = self.captureSaveState()
+        
+        self.saveStateQueue.async {
+            let backgroundContext = DatabaseManager.shared.newBackgroundContext()
+            backgroundContext.performAndWait {
+                
+                let game = backgroundContext.object(with: game.objectID) as! Game
+                let fetchRequest = SaveState.fetchRequest(for: game, type: .quick)
+                
+                do
                 {
-                    self.update(quickSaveState)
+                    let saveState: SaveState
+                    
+                    if let quickSaveState = try fetchRequest.execute().first
+                    {
+                        saveState = quickSaveState
+                    }
+                    else
+                    {
+                        saveState = SaveState(context: backgroundContext)
+                        saveState.type = .quick
+                        saveState.game = game
+                    }
+                    
+                    self.write(capturedSaveState, to: saveState)
+                    
+                    saveState.modifiedDate = Date()
+                    saveState.coreIdentifier = capturedSaveState.coreIdentifier
+                    saveState.coreVersion = capturedSaveState.coreVersion
                 }
-                else
+                catch
                 {
-                    let saveState = SaveState(context: backgroundContext)
-                    saveState.type = .quick
-                    saveState.game = game
-                    
-                    self.update(saveState)
+                    print(error)
                 }
-            }
-            catch
-            {
-                print(error)
+                
+                backgroundContext.saveWithErrorLogging()
             }
             
-            backgroundContext.saveWithErrorLogging()
+            DispatchQueue.main.async {
+                if ExperimentalFeatures.shared.toastNotifications.stateSaveEnabled
+                {
+                    self.presentExperimentalToastView(NSLocalizedString("Saved Save State", comment: ""))
+                }
+            }
         }
     }
     
@@ -1407,19 +1653,27 @@ extension GameViewController
         
         guard let game = self.game as? Game, let emulatorCore, !emulatorCore.isWirelessMultiplayerActive else { return }
         
-        let fetchRequest = SaveState.fetchRequest(for: game, type: .quick)
-        
-        do
-        {
-            if let quickSaveState = try DatabaseManager.shared.viewContext.fetch(fetchRequest).first
-            {
-                self.load(quickSaveState)
+        // Wait for any in-progress quick save to finish writing first, without blocking main thread.
+        self.saveStateQueue.async {
+            DispatchQueue.main.async {
+                // Game may have changed while waiting.
+                guard game == (self.game as? Game) else { return }
+                
+                let fetchRequest = SaveState.fetchRequest(for: game, type: .quick)
+                
+                do
+                {
+                    if let quickSaveState = try DatabaseManager.shared.viewContext.fetch(fetchRequest).first
+                    {
+                        self.load(quickSaveState)
+                    }
+                }
+                catch
+                {
+                    print(error)
+                }
             }
         }
-        catch
-        {
-            print(error)
-        }
     }
     
     func performFastForwardAction(activate: Bool)
@@ -1445,14 +1699,30 @@ extension GameViewController
                 speed = emulatorCore.deltaCore.supportedRates.upperBound
             }
 
+            let rate: Double
             if speed <= emulatorCore.deltaCore.supportedRates.upperBound ||
                 ExperimentalFeatures.shared.variableFastForward.allowUnrestrictedSpeeds
             {
-                emulatorCore.rate = speed
+                rate = speed
             }
             else
             {
-                emulatorCore.rate = emulatorCore.deltaCore.supportedRates.upperBound
+                rate = emulatorCore.deltaCore.supportedRates.upperBound
+            }
+            
+            if ExperimentalFeatures.shared.variableFastForward.isEnabled && ExperimentalFeatures.shared.variableFastForward.isAdaptive
+            {
+                if self.fastForwardController?.emulatorCore !== emulatorCore
+                {
+                    self.fastForwardController = FastForwardController(emulatorCore: emulatorCore)
+                    self.updateFrameObservers()
+                }
+                
+                self.fastForwardController?.start(requestedRate: rate)
+            }
+            else
+            {
+                emulatorCore.rate = rate
             }
 
             if ExperimentalFeatures.shared.toastNotifications.fastForwardEnabled
@@ -1462,15 +1732,57 @@ extension GameViewController
         }
         else
         {
-            emulatorCore.rate = emulatorCore.deltaCore.supportedRates.lowerBound
+            var toastText = NSLocalizedString("Fast Forward Disabled", comment: "")
+            
+            if let fastForwardController = self.fastForwardController, fastForwardController.isActive, let statistics = fastForwardController.stop()
+            {
+                Logger.main.info("Adaptive fast forward achieved \(statistics.achievedRate, format: .fixed(precision: 2))x, max sustained \(statistics.maximumSustainedRate, format: .fixed(precision: 2))x (requested \(statistics.requestedRate, format: .fixed(precision: 2))x).")
+                
+                if statistics.maximumSustainedRate > 0
+                {
+                    let achievedSpeed = FastForwardSpeed(rawValue: statistics.maximumSustainedRate)
+                    let requestedSpeed = FastForwardSpeed(rawValue: statistics.requestedRate)
+                    toastText = String(format: NSLocalizedString("Fast Forward Disabled (%@ of %@)", comment: ""), achievedSpeed.description, requestedSpeed.description)
+                }
+            }
+            else
+            {
+                emulatorCore.rate = emulatorCore.deltaCore.supportedRates.lowerBound
+            }
 
             if ExperimentalFeatures.shared.toastNotifications.fastForwardEnabled
             {
-                self.presentExperimentalToastView(NSLocalizedString("Fast Forward Disabled", comment: ""))
+                self.presentExperimentalToastView(toastText)
             }
         }
     }
     
+    func performRewindAction(activate: Bool)
+    {
+        guard let rewindController = self.rewindController else { return }
+        
+        if activate
+        {
+            // Rewinding is equivalent to loading save states, so disable when using RetroAchievements Hardcore Mode.
+            guard !ExperimentalFeatures.shared.retroAchievements.isEnabled || !ExperimentalFeatures.shared.retroAchievements.isHardcoreModeEnabled else { return }
+            guard let emulatorCore, !emulatorCore.isWirelessMultiplayerActive else { return }
+            
+            // Audio would repeat the same frame over and over while rewinding.
+            emulatorCore.audioManager.isEnabled = false
+            rewindController.isRewinding = true
+        }
+        else
+        {
+            guard rewindController.isRewinding else { return }
+            
+            rewindController.isRewinding = false
+            self.emulatorCore?.audioManager.isEnabled = true
+            
+            let statistics = rewindController.statistics
+            Logger.main.info("Rewind history: \(statistics.duration, format: .fixed(precision: 1))s (\(statistics.snapshotCount) snapshots), History: \(statistics.usedBytes / 1024)KB/\(statistics.memoryBudget / 1024)KB, Allocated: \(statistics.allocatedBytes / 1024)KB, Average Delta: \(Int(statistics.deltaSize.value) / 1024)KB, Capture: \(statistics.captureDuration.value * 1000, format: .fixed(precision: 2))ms avg, \(statistics.captureDuration.maximum * 1000, format: .fixed(precision: 2))ms max")
+        }
+    }
+    
     func performScreenshotAction()
     {
         guard let emulatorCore, let snapshot = emulatorCore.videoManager.snapshot() else { return }
@@ -1617,6 +1929,8 @@ private extension GameViewController
             gameView.setNeedsLayout()
             gameView.layoutIfNeeded()
         }
+        
+        self.updateFrameDecimation()
     }
     
     func disconnectExternalDisplay(for scene: ExternalDisplayScene)
@@ -1633,6 +1947,7 @@ private extension GameViewController
         
         self.updateControllerSkin() // Reset TouchControllerSkin + GameViews
         self.updateGameViews() // Ensure we re-enable GameView and hide AirPlay message.
+        self.updateFrameDecimation()
     }
 }
 
@@ -1939,6 +2254,8 @@ extension GameViewController: NSUserActivityDelegate
         guard self.isContinuingHandoff else { return }
         self.isContinuingHandoff = false
         
+        self.handoffProgressObservation = nil
+        
         self.updateGameViews()
         
         UIView.animate(withDuration: 0.4) {
@@ -1999,24 +2316,59 @@ extension GameViewController: NSUserActivityDelegate
             self.pauseEmulation()
         }
         
+        // Capture state while paused, so what we send always matches the point emulation was paused at (even if we resume after failing).
         let temporaryURL = FileManager.default.uniqueTemporaryURL()
         self.emulatorCore?.saveSaveState(to: temporaryURL)
         
+        // Some cores (e.g. N64) finish writing save states asynchronously without notifying us,
+        // so always wait at least this long before reading it (matching what we did before supporting chunks).
+        let flushDeadline = Date().addingTimeInterval(GameViewController.saveStateFlushDuration)
+        
         Task<Void, Never> {
+            var isResumable = false
+            defer {
+                if !isResumable
+                {
+                    try? FileManager.default.removeItem(at: temporaryURL)
+                }
+            }
+            
             do
             {
-                if #available(iOS 16, *)
+                // Receiving device sends request first, unless it's running an older version of Delta.
+                let request: HandoffSaveStateRequest? = try await inputStream.receive(timeout: 0.5)
+                
+                let remainingFlushTime = flushDeadline.timeIntervalSinceNow
+                if remainingFlushTime > 0
                 {
-                    // Wait for save state to flush to disk (necessary for N64).
-                    try await Task.sleep(for: .seconds(0.5))
-                }
-
-                defer {
-                    try? FileManager.default.removeItem(at: temporaryURL)
+                    try await Task.sleep(nanoseconds: UInt64(remainingFlushTime * Double(NSEC_PER_SEC)))
                 }
                 
-                let data = try Data(contentsOf: temporaryURL)
-                try await outputStream.send(data)
+                if let request, request.supportsChunks
+                {
+                    if let transferID = request.transferID, let handoffTransfer = self.handoffTransfer, handoffTransfer.id == transferID
+                    {
+                        // Receiving device is retrying an interrupted transfer, so resume sending the save state it was already receiving.
+                        try await outputStream.sendFile(at: handoffTransfer.fileURL, offset: request.offset ?? 0, compress: request.supportsCompression)
+                    }
+                    else
+                    {
+                        if let transferID = request.transferID
+                        {
+                            self.handoffTransfer = (transferID, temporaryURL)
+                            isResumable = true
+                        }
+                        
+                        try await outputStream.sendFile(at: temporaryURL, compress: request.supportsCompression)
+                    }
+                    
+                    self.handoffTransfer = nil
+                }
+                else
+                {
+                    let data = try Data(contentsOf: temporaryURL)
+                    try await outputStream.send(data)
+                }
                 
                 self.quitEmulation()
             }
@@ -2084,6 +2436,202 @@ private extension GameViewController
     }
 }
 
+//MARK: - Run-Ahead -
+private extension GameViewController
+{
+    func updateRunAhead()
+    {
+        let frameCount = (self.game as? Game)?.settings[.runAheadFrames] as? Int ?? 0
+        guard frameCount != self.runAheadController?.frameCount || self.emulatorCore !== self.runAheadController?.emulatorCore else { return }
+        
+        if let runAheadController = self.runAheadController
+        {
+            let statistics = runAheadController.statistics
+            Logger.main.info("Stopped running \(runAheadController.frameCount) frame(s) ahead. Average: \(statistics.duration.value * 1000, format: .fixed(precision: 2))ms, Max: \(statistics.duration.maximum * 1000, format: .fixed(precision: 2))ms, Over Budget: \(statistics.overBudgetFrames)/\(statistics.frames)")
+        }
+        
+        if let emulatorCore
+        {
+            self.runAheadController = RunAheadController(emulatorCore: emulatorCore, frameCount: frameCount)
+        }
+        else
+        {
+            self.runAheadController = nil
+        }
+        
+        self.updateFrameObservers()
+    }
+}
+
+//MARK: - Frame Observers -
+private extension GameViewController
+{
+    func updateFrameObservers()
+    {
+        guard let emulatorCore else {
+            self.frameHook = nil
+            return
+        }
+        
+        if self.frameHook?.emulatorCore !== emulatorCore
+        {
+            self.frameHook = FrameHook(emulatorCore: emulatorCore)
+        }
+        
+        var observers = [FrameObserving]()
+        
+        // Rewind first, so run-ahead and others see the rewound frame.
+        if let rewindController = self.rewindController
+        {
+            observers.append(rewindController)
+        }
+        
+        if let runAheadController = self.runAheadController
+        {
+            observers.append(runAheadController)
+        }
+        
+        // After run-ahead, which may present a frame itself.
+        if #available(iOS 18, *), let performanceHUDView = self.performanceHUDView as? PerformanceHUDView, performanceHUDView.trace.emulatorCore === emulatorCore
+        {
+            observers.append(performanceHUDView.trace)
+        }
+        
+        if let frameDecimationController = self.frameDecimationController
+        {
+            observers.append(frameDecimationController)
+        }
+        
+        if let fastForwardController = self.fastForwardController, fastForwardController.emulatorCore === emulatorCore
+        {
+            observers.append(fastForwardController)
+        }
+        
+        self.frameHook?.observers = observers
+    }
+}
+
+//MARK: - Rewind -
+private extension GameViewController
+{
+    func updateRewind()
+    {
+        guard ExperimentalFeatures.shared.rewind.isEnabled, let emulatorCore else {
+            self.rewindController = nil
+            self.updateFrameObservers()
+            return
+        }
+        
+        if let rewindController = self.rewindController, rewindController.emulatorCore === emulatorCore
+        {
+            // Game changed, but emulator core didn't, so discard history from previous game.
+            rewindController.reset()
+        }
+        else
+        {
+            let memoryBudget = Int(ExperimentalFeatures.shared.rewind.memoryLimit) * 1024 * 1024
+            let snapshotsPerSecond = Int(ExperimentalFeatures.shared.rewind.snapshotsPerSecond)
+            self.rewindController = RewindController(emulatorCore: emulatorCore, memoryBudget: memoryBudget, snapshotsPerSecond: snapshotsPerSecond)
+        }
+        
+        self.updateFrameObservers()
+    }
+}
+
+//MARK: - Frame Decimation -
+private extension GameViewController
+{
+    func updateFrameDecimation()
+    {
+        guard let emulatorCore else {
+            self.frameDecimationController = nil
+            self.updateFrameObservers()
+            return
+        }
+        
+        // Only present frames as fast as the slowest display showing the game can refresh.
+        var displayRefreshRate = (self.view.window?.screen ?? UIScreen.main).maximumFramesPerSecond
+        if let scene = UIApplication.shared.externalDisplayScene, scene.gameViewController.delegate === self
+        {
+            displayRefreshRate = min(displayRefreshRate, scene.screen.maximumFramesPerSecond)
+        }
+        
+        if let frameDecimationController = self.frameDecimationController, frameDecimationController.emulatorCore === emulatorCore
+        {
+            frameDecimationController.displayRefreshRate = Double(displayRefreshRate)
+        }
+        else
+        {
+            self.frameDecimationController = FrameDecimationController(emulatorCore: emulatorCore, policy: .displayRefreshRate, displayRefreshRate: Double(displayRefreshRate))
+            self.updateFrameObservers()
+        }
+    }
+}
+
+//MARK: - Performance HUD -
+private extension GameViewController
+{
+    func updatePerformanceHUD()
+    {
+        guard #available(iOS 18, *), ExperimentalFeatures.shared.performanceHUD.isEnabled, let emulatorCore else {
+            self.performanceHUDView?.removeFromSuperview()
+            self.performanceHUDView = nil
+            self.updateFrameObservers()
+            return
+        }
+        
+        if let performanceHUDView = self.performanceHUDView as? PerformanceHUDView, performanceHUDView.trace.emulatorCore === emulatorCore
+        {
+            return
+        }
+        
+        self.performanceHUDView?.removeFromSuperview()
+        
+        let trace = PerformanceTrace(emulatorCore: emulatorCore)
+        
+        let performanceHUDView = PerformanceHUDView(trace: trace)
+        performanceHUDView.translatesAutoresizingMaskIntoConstraints = false
+        performanceHUDView.showsFrameGraph = ExperimentalFeatures.shared.performanceHUD.showsFrameGraph
+        performanceHUDView.exportHandler = { [weak self, weak performanceHUDView] format in
+            guard let self, let performanceHUDView else { return }
+            self.exportPerformanceTrace(performanceHUDView.trace, format: format, sourceView: performanceHUDView)
+        }
+        self.view.addSubview(performanceHUDView)
+        
+        NSLayoutConstraint.activate([
+            performanceHUDView.leadingAnchor.constraint(equalTo: self.view.safeAreaLayoutGuide.leadingAnchor, constant: 8),
+            performanceHUDView.topAnchor.constraint(equalTo: self.view.safeAreaLayoutGuide.topAnchor, constant: 8)
+        ])
+        
+        self.performanceHUDView = performanceHUDView
+        self.updateFrameObservers()
+    }
+    
+    @available(iOS 18, *)
+    func exportPerformanceTrace(_ trace: PerformanceTrace, format: PerformanceTrace.ExportFormat, sourceView: UIView)
+    {
+        do
+        {
+            let fileURL = try trace.export(format)
+            
+            let activityViewController = UIActivityViewController(activityItems: [fileURL], applicationActivities: nil)
+            activityViewController.popoverPresentationController?.sourceView = sourceView
+            activityViewController.popoverPresentationController?.sourceRect = sourceView.bounds
+            activityViewController.completionWithItemsHandler = { _, _, _, _ in
+                try? FileManager.default.removeItem(at: fileURL)
+            }
+            self.present(activityViewController, animated: true)
+        }
+        catch
+        {
+            Logger.main.error("Failed to export performance trace. \(error.localizedDescription, privacy: .public)")
+            
+            let alertController = UIAlertController(title: NSLocalizedString("Unable to Export Performance Trace", comment: ""), error: error)
+            self.present(alertController, animated: true)
+        }
+    }
+}
+
 //MARK: - Notifications -
 private extension GameViewController
 {
@@ -2103,13 +2651,20 @@ private extension GameViewController
     
     @objc func managedObjectContextDidChange(with notification: Notification)
     {
-        guard let deletedObjects = notification.userInfo?[NSDeletedObjectsKey] as? Set<NSManagedObject> else { return }
         guard let game = self.game as? Game else { return }
         
-        if deletedObjects.contains(game)
+        if let deletedObjects = notification.userInfo?[NSDeletedObjectsKey] as? Set<NSManagedObject>, deletedObjects.contains(game)
         {
             self.emulatorCore?.gameViews.forEach { $0.inputImage = nil }
             self.game = nil
+            return
+        }
+        
+        let updatedObjects = (notification.userInfo?[NSUpdatedObjectsKey] as? Set<NSManagedObject> ?? []).union(notification.userInfo?[NSRefreshedObjectsKey] as? Set<NSManagedObject> ?? [])
+        if updatedObjects.contains(game)
+        {
+            // Game settings may have changed (e.g. via GameSettingsView).
+            self.updateRunAhead()
         }
     }
     
@@ -2145,6 +2700,10 @@ private extension GameViewController
         case Settings.features.dsAirPlay.$layoutAxis.settingsKey:
             self.updateExternalDisplay()
         
+        case ExperimentalFeatures.shared.autoSaveCheckpoints.settingsKey: fallthrough
+        case ExperimentalFeatures.shared.autoSaveCheckpoints.$checkpointInterval.settingsKey:
+            self.updateAutoSaveCheckpoints()
+            
         case ExperimentalFeatures.shared.airPlaySkins.settingsKey: fallthrough
         case _ where settingsName.rawValue.hasPrefix(ExperimentalFeatures.shared.airPlaySkins.settingsKey.rawValue):
             // Update whenever any of the AirPlay skins have changed.
@@ -2179,6 +2738,20 @@ private extension GameViewController
         self.game = game
         self.prepareForHandoff()
         
+        self.handoffPlaceholderView.detailTextLabel.text = NSLocalizedString("Resuming…", comment: "")
+        
+        if let progress = notification.userInfo?[DeepLink.Key.progress] as? Progress
+        {
+            self.handoffProgressObservation = progress.observe(\.fractionCompleted) { [weak self] (progress, change) in
+                guard progress.totalUnitCount > 0 else { return }
+                
+                let percentage = Int(progress.fractionCompleted * 100)
+                DispatchQueue.main.async {
+                    self?.handoffPlaceholderView.detailTextLabel.text = String(format: NSLocalizedString("Resuming… %@%%", comment: ""), NSNumber(value: percentage))
+                }
+            }
+        }
+        
         self.returnToGameViewController()
     }
     
@@ -2333,6 +2906,7 @@ private extension GameViewController
         }
         
         emulatorCore.isWirelessMultiplayerActive = true
+        self.fastForwardController?.stop()
         emulatorCore.rate = 1.0 // Disable FF in case it is currently enabled.
         
         DispatchQueue.main.async {
@@ -0,0 +1,26 @@
+//
+//  MovingAverage.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Exponential moving average, so value reflects recent samples more than older ones.
+struct MovingAverage
+{
+    static let smoothingFactor = 0.95
+    
+    private(set) var value: Double = 0
+    private(set) var maximum: Double = 0
+    private(set) var count = 0
+    
+    mutating func add(_ sample: Double)
+    {
+        self.value = (self.count == 0) ? sample : (self.value * MovingAverage.smoothingFactor + sample * (1 - MovingAverage.smoothingFactor))
+        self.maximum = max(sample, self.maximum)
+        self.count += 1
+    }
+}
@@ -0,0 +1,209 @@
+//
+//  PerformanceHUDView.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import UIKit
+
+// Overlay that shows live emulation performance from a PerformanceTrace.
+// Long-press to export the trace.
+@available(iOS 18, *)
+final class PerformanceHUDView: UIView
+{
+    let trace: PerformanceTrace
+    
+    var showsFrameGraph = true {
+        didSet {
+            self.graphView.isHidden = !self.showsFrameGraph
+        }
+    }
+    
+    var exportHandler: ((PerformanceTrace.ExportFormat) -> Void)?
+    
+    private let textLabel = UILabel()
+    private let graphView = FrameGraphView()
+    
+    private var updateTimer: Timer?
+    
+    init(trace: PerformanceTrace)
+    {
+        self.trace = trace
+        
+        super.init(frame: .zero)
+        
+        self.backgroundColor = UIColor.black.withAlphaComponent(0.6)
+        self.layer.cornerRadius = 8
+        self.layer.cornerCurve = .continuous
+        self.clipsToBounds = true
+        
+        self.textLabel.font = UIFont.monospacedDigitSystemFont(ofSize: 11, weight: .medium)
+        self.textLabel.textColor = .white
+        self.textLabel.numberOfLines = 0
+        
+        let stackView = UIStackView(arrangedSubviews: [self.textLabel, self.graphView])
+        stackView.translatesAutoresizingMaskIntoConstraints = false
+        stackView.axis = .vertical
+        stackView.spacing = 4
+        self.addSubview(stackView)
+        
+        NSLayoutConstraint.activate([
+            stackView.leadingAnchor.constraint(equalTo: self.leadingAnchor, constant: 8),
+            stackView.trailingAnchor.constraint(equalTo: self.trailingAnchor, constant: -8),
+            stackView.topAnchor.constraint(equalTo: self.topAnchor, constant: 6),
+            stackView.bottomAnchor.constraint(equalTo: self.bottomAnchor, constant: -6),
+            self.graphView.heightAnchor.constraint(equalToConstant: 30),
+            self.graphView.widthAnchor.constraint(equalToConstant: 160)
+        ])
+        
+        self.addInteraction(UIContextMenuInteraction(delegate: self))
+    }
+    
+    required init?(coder: NSCoder)
+    {
+        fatalError("init(coder:) has not been implemented")
+    }
+    
+    override func didMoveToWindow()
+    {
+        super.didMoveToWindow()
+        
+        self.updateTimer?.invalidate()
+        self.updateTimer = nil
+        
+        guard self.window != nil else { return }
+        
+        // Updating a few times per second is plenty for a human to read, and keeps HUD from affecting what it measures.
+        let timer = Timer(timeInterval: 0.25, repeats: true) { [weak self] _ in
+            self?.update()
+        }
+        RunLoop.main.add(timer, forMode: .common)
+        self.updateTimer = timer
+        
+        self.update()
+    }
+}
+
+@available(iOS 18, *)
+private extension PerformanceHUDView
+{
+    func update()
+    {
+        let summary = self.trace.summary(interval: 1.0)
+        
+        guard summary.frameCount > 0 else {
+            self.textLabel.text = NSLocalizedString("Paused", comment: "")
+            return
+        }
+        
+        var lines = [String]()
+        lines.append(String(format: "%.1f FPS  %.2fms (max %.2fms)", 1.0 / summary.averageFrameInterval, summary.averageFrameInterval * 1000, summary.maximumFrameInterval * 1000))
+        
+        lines.append(String(format: "Emulate: %.2fms", summary.averageEmulationDuration * 1000))
+        lines.append(String(format: "Speed: %.2fx / %.2fx", summary.achievedRate, summary.rate))
+        lines.append(String(format: "Audio: %d%%  Underruns: %d", Int(summary.audioBufferLevel * 100), summary.audioUnderrunCount))
+        
+        if summary.skippedFrameCount > 0
+        {
+            lines.append(String(format: "Presented: %d  Skipped: %d", summary.presentedFrameCount, summary.skippedFrameCount))
+        }
+        
+        self.textLabel.text = lines.joined(separator: "\n")
+        
+        if self.showsFrameGraph
+        {
+            let frameIntervals = self.trace.recentSamples(count: 120).map { TimeInterval($0.frameInterval) }
+            let targetFrameInterval = self.trace.emulatorCore.deltaCore.emulatorBridge.frameDuration / max(summary.rate, 1)
+            self.graphView.update(frameIntervals: frameIntervals, targetFrameInterval: targetFrameInterval)
+        }
+    }
+}
+
+@available(iOS 18, *)
+extension PerformanceHUDView: UIContextMenuInteractionDelegate
+{
+    func contextMenuInteraction(_ interaction: UIContextMenuInteraction, configurationForMenuAtLocation location: CGPoint) -> UIContextMenuConfiguration?
+    {
+        let configuration = UIContextMenuConfiguration(identifier: nil, previewProvider: nil) { [weak self] _ in
+            let exportJSONAction = UIAction(title: NSLocalizedString("Export as JSON", comment: ""), image: UIImage(systemName: "curlybraces")) { _ in
+                self?.exportHandler?(.json)
+            }
+            
+            let exportCSVAction = UIAction(title: NSLocalizedString("Export as CSV", comment: ""), image: UIImage(systemName: "tablecells")) { _ in
+                self?.exportHandler?(.csv)
+            }
+            
+            return UIMenu(title: NSLocalizedString("Performance Trace", comment: ""), children: [exportJSONAction, exportCSVAction])
+        }
+        
+        return configuration
+    }
+}
+
+// Bar graph of recent frame intervals. Bars exceeding target frame interval are highlighted.
+private class FrameGraphView: UIView
+{
+    private var frameIntervals = [TimeInterval]()
+    private var targetFrameInterval: TimeInterval = 0
+    
+    override init(frame: CGRect)
+    {
+        super.init(frame: frame)
+        
+        self.isOpaque = false
+        self.contentMode = .redraw
+    }
+    
+    required init?(coder: NSCoder)
+    {
+        fatalError("init(coder:) has not been implemented")
+    }
+    
+    func update(frameIntervals: [TimeInterval], targetFrameInterval: TimeInterval)
+    {
+        self.frameIntervals = frameIntervals
+        self.targetFrameInterval = targetFrameInterval
+        
+        self.setNeedsDisplay()
+    }
+    
+    override func draw(_ rect: CGRect)
+    {
+        guard !self.frameIntervals.isEmpty, self.targetFrameInterval > 0 else { return }
+        
+        // Scale so 2x target frame interval fills graph.
+        let maximumInterval = self.targetFrameInterval * 2
+        let barWidth = self.bounds.width / CGFloat(self.frameIntervals.count)
+        
+        let normalPath = UIBezierPath()
+        let slowPath = UIBezierPath()
+        
+        for (index, frameInterval) in self.frameIntervals.enumerated()
+        {
+            let height = self.bounds.height * CGFloat(min(frameInterval / maximumInterval, 1.0))
+            let barRect = CGRect(x: CGFloat(index) * barWidth, y: self.bounds.height - height, width: max(barWidth - 0.5, 0.5), height: height)
+            
+            // Allow some tolerance for timer jitter.
+            let path = (frameInterval > self.targetFrameInterval * 1.2) ? slowPath : normalPath
+            path.append(UIBezierPath(rect: barRect))
+        }
+        
+        UIColor.systemGreen.setFill()
+        normalPath.fill()
+        
+        UIColor.systemRed.setFill()
+        slowPath.fill()
+        
+        // Target line
+        let targetY = self.bounds.height / 2
+        let targetPath = UIBezierPath()
+        targetPath.move(to: CGPoint(x: 0, y: targetY))
+        targetPath.addLine(to: CGPoint(x: self.bounds.width, y: targetY))
+        targetPath.lineWidth = 0.5
+        
+        UIColor.white.withAlphaComponent(0.5).setStroke()
+        targetPath.stroke()
+    }
+}
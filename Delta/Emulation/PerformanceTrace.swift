@@ -0,0 +1,258 @@
+//
+//  PerformanceTrace.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+import Synchronization
+
+import DeltaCore
+
+// Records timing information for every emulated frame into a fixed-size ring buffer.
+//
+// Samples are written by the emulation thread and read by the HUD + exporters without any locks:
+// the writer fills in a sample, then publishes it by incrementing writeIndex. Readers copy samples,
+// then discard any that the writer may have overwritten while copying.
+//
+// This is best-effort: samples aren't individually synchronized, so a sample the writer is overwriting
+// at the exact moment it's copied can very occasionally be torn. That's acceptable for a diagnostic HUD,
+// and avoids adding any synchronization cost to the emulation thread.
+@available(iOS 18, *)
+final class PerformanceTrace: FrameObserving
+{
+    struct Sample: Codable
+    {
+        var timestamp: TimeInterval // Seconds since trace started.
+        
+        // Wall-clock time since previous frame.
+        var frameInterval: Float
+        
+        // CPU time emulation thread spent on frame, including rendering and frame observers (e.g. run-ahead).
+        // Unlike frameInterval, this excludes time spent waiting for next frame, so it shows how much of the frame budget is actually used.
+        var emulationDuration: Float
+        
+        var rate: Float
+        var isPresented: Bool
+        
+        // Fraction of audio buffer filled at end of frame, 0 means audio underran (unless audio is disabled).
+        var audioBufferLevel: Float
+        var isAudioEnabled: Bool
+    }
+    
+    struct Summary
+    {
+        var frameCount = 0
+        
+        var averageFrameInterval: TimeInterval = 0
+        var maximumFrameInterval: TimeInterval = 0
+        var averageEmulationDuration: TimeInterval = 0
+        
+        var rate: Double = 0
+        var achievedRate: Double = 0 // Emulated frames per second relative to core's native frame rate.
+        
+        var audioBufferLevel: Double = 0
+        var audioUnderrunCount = 0
+        
+        var presentedFrameCount = 0
+        var skippedFrameCount = 0
+    }
+    
+    enum ExportFormat
+    {
+        case json
+        case csv
+    }
+    
+    let emulatorCore: EmulatorCore
+    let capacity: Int
+    
+    private let samples: UnsafeMutablePointer<Sample>
+    private let writeIndex = Atomic<Int>(0)
+    
+    private let startTime = DispatchTime.now().uptimeNanoseconds
+    
+    // Only accessed by emulation thread.
+    private var previousFrameTime: UInt64?
+    private var previousThreadCPUTime: UInt64 = 0
+    private var previousThread: pthread_t?
+    
+    init(emulatorCore: EmulatorCore, capacity: Int = 60 * 60) // ~1 minute at 60fps
+    {
+        self.emulatorCore = emulatorCore
+        self.capacity = capacity
+        
+        self.samples = UnsafeMutablePointer<Sample>.allocate(capacity: capacity)
+        self.samples.initialize(repeating: Sample(timestamp: 0, frameInterval: 0, emulationDuration: 0, rate: 0, isPresented: false, audioBufferLevel: 0, isAudioEnabled: false), count: capacity)
+    }
+    
+    deinit
+    {
+        self.samples.deinitialize(count: self.capacity)
+        self.samples.deallocate()
+    }
+    
+    // Returns up to `count` most recent samples, oldest first.
+    func recentSamples(count: Int? = nil) -> [Sample]
+    {
+        let endIndex = self.writeIndex.load(ordering: .acquiring)
+        let startIndex = max(endIndex - min(count ?? self.capacity, self.capacity), 0)
+        
+        var samples = (startIndex ..< endIndex).map { self.samples[$0 % self.capacity] }
+        
+        // Make sure samples are copied before we check whether writer overwrote them.
+        atomicMemoryFence(ordering: .acquiring)
+        
+        // Discard samples the writer may have overwritten while we were copying them.
+        let latestIndex = self.writeIndex.load(ordering: .relaxed)
+        let overwrittenCount = max(latestIndex - self.capacity + 1 - startIndex, 0)
+        samples.removeFirst(min(overwrittenCount, samples.count))
+        
+        return samples
+    }
+    
+    func summary(interval: TimeInterval) -> Summary
+    {
+        let frameDuration = self.emulatorCore.deltaCore.emulatorBridge.frameDuration
+        
+        let samples = self.recentSamples()
+        guard let lastSample = samples.last else { return Summary() }
+        
+        // Return empty summary if no frames have been emulated recently (e.g. because emulation is paused).
+        let currentTimestamp = TimeInterval(DispatchTime.now().uptimeNanoseconds - self.startTime) / TimeInterval(NSEC_PER_SEC)
+        guard currentTimestamp - lastSample.timestamp < interval else { return Summary() }
+        
+        let recentSamples = samples.reversed().prefix { lastSample.timestamp - $0.timestamp < interval }
+        
+        var summary = Summary()
+        summary.frameCount = recentSamples.count
+        summary.rate = Double(lastSample.rate)
+        
+        var totalFrameInterval: TimeInterval = 0
+        var totalEmulationDuration: TimeInterval = 0
+        var totalAudioBufferLevel: Double = 0
+        var audioSampleCount = 0
+        
+        for sample in recentSamples
+        {
+            totalFrameInterval += TimeInterval(sample.frameInterval)
+            summary.maximumFrameInterval = max(TimeInterval(sample.frameInterval), summary.maximumFrameInterval)
+            
+            totalEmulationDuration += TimeInterval(sample.emulationDuration)
+            
+            // Audio is deliberately disabled in some cases (e.g. while rewinding), so an empty buffer isn't always an underrun.
+            if sample.isAudioEnabled
+            {
+                totalAudioBufferLevel += Double(sample.audioBufferLevel)
+                audioSampleCount += 1
+                
+                if sample.audioBufferLevel == 0
+                {
+                    summary.audioUnderrunCount += 1
+                }
+            }
+            
+            if sample.isPresented
+            {
+                summary.presentedFrameCount += 1
+            }
+            else
+            {
+                summary.skippedFrameCount += 1
+            }
+        }
+        
+        guard summary.frameCount > 0 else { return summary }
+        
+        summary.averageFrameInterval = totalFrameInterval / Double(summary.frameCount)
+        summary.averageEmulationDuration = totalEmulationDuration / Double(summary.frameCount)
+        summary.audioBufferLevel = (audioSampleCount > 0) ? totalAudioBufferLevel / Double(audioSampleCount) : 0
+        
+        if summary.averageFrameInterval > 0
+        {
+            summary.achievedRate = frameDuration / summary.averageFrameInterval
+        }
+        
+        return summary
+    }
+    
+    func export(_ format: ExportFormat) throws -> URL
+    {
+        let samples = self.recentSamples()
+        
+        let filename = "Performance Trace \(Int(Date().timeIntervalSince1970))"
+        let fileURL: URL
+        
+        switch format
+        {
+        case .json:
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+            
+            let data = try encoder.encode(samples)
+            
+            fileURL = FileManager.default.temporaryDirectory.appendingPathComponent(filename).appendingPathExtension("json")
+            try data.write(to: fileURL, options: .atomic)
+        
+        case .csv:
+            var csv = "timestamp,frameInterval,emulationDuration,rate,isPresented,audioBufferLevel,isAudioEnabled\n"
+            
+            for sample in samples
+            {
+                csv += "\(sample.timestamp),\(sample.frameInterval),\(sample.emulationDuration),\(sample.rate),\(sample.isPresented ? 1 : 0),\(sample.audioBufferLevel),\(sample.isAudioEnabled ? 1 : 0)\n"
+            }
+            
+            fileURL = FileManager.default.temporaryDirectory.appendingPathComponent(filename).appendingPathExtension("csv")
+            try csv.write(to: fileURL, atomically: true, encoding: .utf8)
+        }
+        
+        return fileURL
+    }
+    
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+    {
+        self.recordFrame(isPresented: frameHook.didPresentFrame)
+    }
+}
+
+@available(iOS 18, *)
+private extension PerformanceTrace
+{
+    func recordFrame(isPresented: Bool)
+    {
+        let now = DispatchTime.now().uptimeNanoseconds
+        let threadCPUTime = clock_gettime_nsec_np(CLOCK_THREAD_CPUTIME_ID)
+        let thread = pthread_self()
+        
+        defer {
+            self.previousFrameTime = now
+            self.previousThreadCPUTime = threadCPUTime
+            self.previousThread = thread
+        }
+        
+        // Don't record time spent paused as a (very) long frame.
+        guard let previousFrameTime = self.previousFrameTime, self.emulatorCore.state == .running else { return }
+        
+        // CPU time is per-thread, so ignore frames where emulation thread changed (e.g. after reloading core for JIT).
+        guard let previousThread = self.previousThread, pthread_equal(thread, previousThread) != 0, threadCPUTime >= self.previousThreadCPUTime else { return }
+        
+        let audioBuffer = self.emulatorCore.audioManager.audioBuffer
+        let bufferSize = audioBuffer.availableBytesForReading + audioBuffer.availableBytesForWriting
+        let audioBufferLevel = (bufferSize > 0) ? Float(audioBuffer.availableBytesForReading) / Float(bufferSize) : 0
+        
+        let sample = Sample(timestamp: TimeInterval(now - self.startTime) / TimeInterval(NSEC_PER_SEC),
+                            frameInterval: Float(TimeInterval(now - previousFrameTime) / TimeInterval(NSEC_PER_SEC)),
+                            emulationDuration: Float(TimeInterval(threadCPUTime - self.previousThreadCPUTime) / TimeInterval(NSEC_PER_SEC)),
+                            rate: Float(self.emulatorCore.rate),
+                            isPresented: isPresented,
+                            audioBufferLevel: audioBufferLevel,
+                            isAudioEnabled: self.emulatorCore.audioManager.isEnabled)
+        
+        // Only the emulation thread writes, so no need for compare-and-exchange.
+        let index = self.writeIndex.load(ordering: .relaxed)
+        self.samples[index % self.capacity] = sample
+        self.writeIndex.store(index + 1, ordering: .releasing)
+    }
+}
@@ -228,7 +228,7 @@ private extension PreviewGameViewController
         {
             do
             {
-                try self.emulatorCore?.load(saveState)
+                try self.emulatorCore?.loadSaveState(saveState)
             }
             catch EmulatorCore.SaveStateError.doesNotExist
             {
@@ -0,0 +1,485 @@
+//
+//  RewindController.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+// Periodically captures emulator state into a fixed-size ring buffer in memory, so games can be rewound while holding the Rewind action.
+//
+// Only the most recent snapshot is stored in full. Every other snapshot is stored as the XOR of itself and the snapshot after it,
+// run-length encoded. Consecutive states are mostly identical, so these deltas are typically a tiny fraction of the full state size.
+// Because XOR is its own inverse, applying the newest delta to the most recent snapshot reconstructs the previous one, and so on.
+final class RewindController: FrameObserving
+{
+    struct Statistics
+    {
+        var memoryBudget: Int
+        
+        // Bytes of memoryBudget currently storing history.
+        var usedBytes = 0
+        
+        // Total memory allocated for rewinding, including full memoryBudget and the most recent snapshot + scratch buffers.
+        var allocatedBytes = 0
+        
+        var snapshotCount = 0
+        var stateSize = 0
+        
+        // How far back we can currently rewind.
+        var duration: TimeInterval = 0
+        
+        var captureDuration = MovingAverage()
+        var deltaSize = MovingAverage()
+    }
+    
+    let emulatorCore: EmulatorCore
+    let memoryBudget: Int
+    
+    // Number of frames between snapshots.
+    let captureInterval: Int
+    
+    var isRewinding: Bool {
+        get { self.lock.withLock { self._isRewinding } }
+        set { self.lock.withLock { self._isRewinding = newValue } }
+    }
+    private var _isRewinding = false
+    
+    var statistics: Statistics {
+        return self.lock.withLock { self._statistics }
+    }
+    private var _statistics: Statistics
+    
+    private let bridge: RunAheadSupporting
+    
+    // Fixed-size ring of encoded deltas, allocated up front so capturing never allocates.
+    private let ringBuffer: UnsafeMutableRawPointer
+    private var entries = [Entry]()
+    private var firstEntryIndex = 0
+    
+    // Most recent snapshot + scratch buffers, sized to emulator's current state size.
+    private var stateSize = 0
+    private var currentState: UnsafeMutableRawPointer?
+    private var capturedState: UnsafeMutableRawPointer?
+    private var encodingBuffer: UnsafeMutableRawPointer?
+    
+    private var framesSinceCapture = 0
+    private var framesSinceRewind = 0
+    
+    private let lock = NSLock()
+    
+    init?(emulatorCore: EmulatorCore, memoryBudget: Int, snapshotsPerSecond: Int)
+    {
+        guard memoryBudget > 0, snapshotsPerSecond > 0, let bridge = emulatorCore.makeRunAheadBridge() else { return nil }
+        
+        self.emulatorCore = emulatorCore
+        self.memoryBudget = memoryBudget
+        self.bridge = bridge
+        
+        let framesPerSecond = 1.0 / emulatorCore.deltaCore.emulatorBridge.frameDuration
+        self.captureInterval = max(Int((framesPerSecond / Double(snapshotsPerSecond)).rounded()), 1)
+        
+        self.ringBuffer = UnsafeMutableRawPointer.allocate(byteCount: memoryBudget, alignment: 16)
+        self._statistics = Statistics(memoryBudget: memoryBudget, allocatedBytes: memoryBudget)
+    }
+    
+    deinit
+    {
+        self.ringBuffer.deallocate()
+        self.deallocateStateBuffers()
+    }
+    
+    // Discards all snapshots, e.g. after loading a save state or resetting the game.
+    func reset()
+    {
+        self.lock.withLock {
+            self.entries.removeAll(keepingCapacity: true)
+            self.firstEntryIndex = 0
+            self.framesSinceCapture = 0
+            
+            self.deallocateStateBuffers()
+            self.updateStatistics()
+        }
+    }
+    
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+    {
+        self.update()
+    }
+}
+
+extension RewindController
+{
+    // Rewinding captures state with the same API as run-ahead (including SaveStateRunAheadAdapter).
+    static func isSupported(by system: System) -> Bool
+    {
+        return system.supportsRunAhead
+    }
+}
+
+private extension RewindController
+{
+    struct Entry
+    {
+        var offset: Int
+        var size: Int
+        
+        // If true, delta was too large to benefit from encoding, so it's stored as-is.
+        var isRaw: Bool
+    }
+    
+    var entryCount: Int {
+        return self.entries.count - self.firstEntryIndex
+    }
+    
+    func update()
+    {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        if self._isRewinding
+        {
+            self.framesSinceCapture = 0
+            self.rewind()
+        }
+        else
+        {
+            self.framesSinceRewind = 0
+            self.framesSinceCapture += 1
+            
+            guard self.framesSinceCapture >= self.captureInterval else { return }
+            self.framesSinceCapture = 0
+            
+            self.capture()
+        }
+    }
+    
+    func capture()
+    {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        
+        let stateSize = self.bridge.runAheadStateSize
+        if stateSize != self.stateSize
+        {
+            // State size changed (or this is our first snapshot), so existing deltas can no longer be applied.
+            self.entries.removeAll(keepingCapacity: true)
+            self.firstEntryIndex = 0
+            
+            self.deallocateStateBuffers()
+            guard stateSize > 0, stateSize <= self.memoryBudget / 2 else { return }
+            
+            self.stateSize = stateSize
+            self.currentState = UnsafeMutableRawPointer.allocate(byteCount: stateSize, alignment: 16)
+            self.capturedState = UnsafeMutableRawPointer.allocate(byteCount: stateSize, alignment: 16)
+            self.encodingBuffer = UnsafeMutableRawPointer.allocate(byteCount: stateSize, alignment: 16)
+            
+            if let currentState = self.currentState, !self.bridge.saveRunAheadState(to: currentState, size: stateSize)
+            {
+                self.deallocateStateBuffers()
+            }
+            
+            self.updateStatistics()
+            return
+        }
+        
+        guard let currentState = self.currentState, let capturedState = self.capturedState, let encodingBuffer = self.encodingBuffer,
+              self.bridge.saveRunAheadState(to: capturedState, size: stateSize)
+        else { return }
+        
+        // Store delta that reconstructs currentState from capturedState.
+        let encodedSize = RewindController.encodeDelta(from: capturedState, to: currentState, count: stateSize, into: encodingBuffer, capacity: stateSize)
+        
+        var entry: Entry
+        if let encodedSize
+        {
+            entry = Entry(offset: 0, size: encodedSize, isRaw: false)
+        }
+        else
+        {
+            // Delta wouldn't compress, so store raw XOR instead.
+            RewindController.xor(capturedState, into: currentState, count: stateSize)
+            entry = Entry(offset: 0, size: stateSize, isRaw: true)
+        }
+        
+        entry.offset = self.reserveSpace(entry.size)
+        
+        let source = entry.isRaw ? UnsafeRawPointer(currentState) : UnsafeRawPointer(encodingBuffer)
+        memcpy(self.ringBuffer + entry.offset, source, entry.size)
+        
+        self.entries.append(entry)
+        
+        // Captured state is now the most recent snapshot.
+        self.currentState = capturedState
+        self.capturedState = currentState
+        
+        let duration = TimeInterval(DispatchTime.now().uptimeNanoseconds - startTime) / TimeInterval(NSEC_PER_SEC)
+        self.record(duration, deltaSize: entry.size)
+    }
+    
+    func rewind()
+    {
+        guard let currentState = self.currentState else { return }
+        
+        // Restore most recent snapshot every frame so game doesn't advance between steps,
+        // then step back to previous snapshot at the same rate we capture them (so rewinding plays at ~1x speed).
+        if self.framesSinceRewind > 0 && self.framesSinceRewind % self.captureInterval == 0, let entry = self.entries.last, self.entryCount > 0
+        {
+            if entry.isRaw
+            {
+                RewindController.xor(self.ringBuffer + entry.offset, into: currentState, count: self.stateSize)
+            }
+            else
+            {
+                RewindController.applyDelta(self.ringBuffer + entry.offset, size: entry.size, to: currentState, count: self.stateSize)
+            }
+            
+            self.entries.removeLast()
+            
+            if self.entryCount == 0
+            {
+                self.entries.removeAll(keepingCapacity: true)
+                self.firstEntryIndex = 0
+            }
+            
+            self.updateStatistics()
+        }
+        
+        self.framesSinceRewind += 1
+        
+        if !self.bridge.loadRunAheadState(from: currentState, size: self.stateSize)
+        {
+            Logger.main.error("Failed to load rewind snapshot.")
+        }
+    }
+    
+    // Returns offset of contiguous region in ring buffer for new entry, evicting oldest entries as needed.
+    func reserveSpace(_ size: Int) -> Int
+    {
+        var offset = 0
+        
+        if let lastEntry = self.entries.last, self.entryCount > 0
+        {
+            offset = lastEntry.offset + lastEntry.size
+            
+            if offset + size > self.memoryBudget
+            {
+                // Not enough room at end of buffer, so evict everything after last entry, then wrap around to beginning.
+                while self.entryCount > 0 && self.entries[self.firstEntryIndex].offset >= offset
+                {
+                    self.firstEntryIndex += 1
+                }
+                
+                offset = 0
+            }
+        }
+        
+        while self.entryCount > 0
+        {
+            let oldestEntry = self.entries[self.firstEntryIndex]
+            
+            // Evict oldest entry if it overlaps new entry's region.
+            guard oldestEntry.offset < offset + size && offset < oldestEntry.offset + oldestEntry.size else { break }
+            self.firstEntryIndex += 1
+        }
+        
+        if self.firstEntryIndex > 1024 && self.firstEntryIndex > self.entries.count / 2
+        {
+            // Periodically compact entries so evicted entries don't accumulate.
+            self.entries.removeFirst(self.firstEntryIndex)
+            self.firstEntryIndex = 0
+        }
+        
+        return offset
+    }
+    
+    // Must be called while holding lock.
+    func record(_ captureDuration: TimeInterval, deltaSize: Int)
+    {
+        self._statistics.captureDuration.add(captureDuration)
+        self._statistics.deltaSize.add(Double(deltaSize))
+        
+        self.updateStatistics()
+    }
+    
+    // Must be called while holding lock.
+    func updateStatistics()
+    {
+        let entries = self.entries[self.firstEntryIndex...]
+        let frameDuration = self.emulatorCore.deltaCore.emulatorBridge.frameDuration
+        
+        self._statistics.snapshotCount = entries.count + (self.currentState != nil ? 1 : 0)
+        self._statistics.stateSize = self.stateSize
+        self._statistics.usedBytes = entries.reduce(0) { $0 + $1.size }
+        self._statistics.allocatedBytes = self.memoryBudget + self.stateSize * 3
+        self._statistics.duration = Double(entries.count * self.captureInterval) * frameDuration
+    }
+    
+    func deallocateStateBuffers()
+    {
+        self.currentState?.deallocate()
+        self.capturedState?.deallocate()
+        self.encodingBuffer?.deallocate()
+        
+        self.currentState = nil
+        self.capturedState = nil
+        self.encodingBuffer = nil
+        self.stateSize = 0
+    }
+}
+
+private extension RewindController
+{
+    // Runs of matching bytes shorter than this are stored as literals, since encoding them would cost more than it saves.
+    static let minimumZeroRunLength = 8
+    
+    // Encodes `previous XOR current` as a series of (zero run length, literal length, literal bytes) tuples.
+    // Returns nil if encoded delta would exceed capacity.
+    static func encodeDelta(from previous: UnsafeRawPointer, to current: UnsafeRawPointer, count: Int, into output: UnsafeMutableRawPointer, capacity: Int) -> Int?
+    {
+        let previousBytes = previous.assumingMemoryBound(to: UInt8.self)
+        let currentBytes = current.assumingMemoryBound(to: UInt8.self)
+        let outputBytes = output.assumingMemoryBound(to: UInt8.self)
+        
+        var outputSize = 0
+        
+        func write(_ value: Int) -> Bool
+        {
+            // LEB128 varint
+            var value = UInt(value)
+            repeat
+            {
+                guard outputSize < capacity else { return false }
+                
+                var byte = UInt8(value & 0x7F)
+                value >>= 7
+                
+                if value != 0
+                {
+                    byte |= 0x80
+                }
+                
+                outputBytes[outputSize] = byte
+                outputSize += 1
+            }
+            while value != 0
+            
+            return true
+        }
+        
+        func matchingRunLength(at index: Int) -> Int
+        {
+            var length = 0
+            
+            // Compare 8 bytes at a time where possible.
+            while index + length + 8 <= count && (previous + index + length).loadUnaligned(as: UInt64.self) == (current + index + length).loadUnaligned(as: UInt64.self)
+            {
+                length += 8
+            }
+            
+            while index + length < count && previousBytes[index + length] == currentBytes[index + length]
+            {
+                length += 1
+            }
+            
+            return length
+        }
+        
+        var index = 0
+        while index < count
+        {
+            let zeroRunLength = matchingRunLength(at: index)
+            index += zeroRunLength
+            
+            let literalStart = index
+            while index < count
+            {
+                let runLength = matchingRunLength(at: index)
+                if runLength >= RewindController.minimumZeroRunLength || index + runLength == count
+                {
+                    break
+                }
+                
+                // Include short matching run + next differing byte in literal.
+                index += runLength + 1
+            }
+            
+            let literalLength = index - literalStart
+            
+            guard write(zeroRunLength), write(literalLength), outputSize + literalLength <= capacity else { return nil }
+            
+            for i in 0 ..< literalLength
+            {
+                outputBytes[outputSize + i] = previousBytes[literalStart + i] ^ currentBytes[literalStart + i]
+            }
+            
+            outputSize += literalLength
+        }
+        
+        return outputSize
+    }
+    
+    static func applyDelta(_ delta: UnsafeRawPointer, size: Int, to state: UnsafeMutableRawPointer, count: Int)
+    {
+        let deltaBytes = delta.assumingMemoryBound(to: UInt8.self)
+        let stateBytes = state.assumingMemoryBound(to: UInt8.self)
+        
+        var deltaOffset = 0
+        
+        func read() -> Int
+        {
+            var value = 0
+            var shift = 0
+            
+            while deltaOffset < size
+            {
+                let byte = deltaBytes[deltaOffset]
+                deltaOffset += 1
+                
+                value |= Int(byte & 0x7F) << shift
+                shift += 7
+                
+                guard byte & 0x80 != 0 else { break }
+            }
+            
+            return value
+        }
+        
+        var index = 0
+        while index < count && deltaOffset < size
+        {
+            index += read()
+            
+            let literalLength = min(read(), count - index, size - deltaOffset)
+            for i in 0 ..< literalLength
+            {
+                stateBytes[index + i] ^= deltaBytes[deltaOffset + i]
+            }
+            
+            index += literalLength
+            deltaOffset += literalLength
+        }
+    }
+    
+    static func xor(_ source: UnsafeRawPointer, into destination: UnsafeMutableRawPointer, count: Int)
+    {
+        var index = 0
+        
+        while index + 8 <= count
+        {
+            let value = (source + index).loadUnaligned(as: UInt64.self) ^ UnsafeRawPointer(destination + index).loadUnaligned(as: UInt64.self)
+            (destination + index).storeBytes(of: value, as: UInt64.self)
+            index += 8
+        }
+        
+        while index < count
+        {
+            let value = source.load(fromByteOffset: index, as: UInt8.self) ^ destination.load(fromByteOffset: index, as: UInt8.self)
+            destination.storeBytes(of: value, toByteOffset: index, as: UInt8.self)
+            index += 1
+        }
+    }
+}
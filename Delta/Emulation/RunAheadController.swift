@@ -0,0 +1,163 @@
+//
+//  RunAheadController.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+// Adopted by emulator bridges that can serialize state to memory and run frames without outputting audio.
+// Bridges that don't adopt this use SaveStateRunAheadAdapter instead, if their system supports it.
+@objc(DLTARunAheadSupporting)
+protocol RunAheadSupporting: NSObjectProtocol
+{
+    // Maximum number of bytes required to serialize state.
+    var runAheadStateSize: Int { get }
+    
+    func saveRunAheadState(to buffer: UnsafeMutableRawPointer, size: Int) -> Bool
+    func loadRunAheadState(from buffer: UnsafeRawPointer, size: Int) -> Bool
+    
+    // Runs frame without outputting any audio.
+    func runHiddenFrame(processVideo: Bool)
+}
+
+// Hides games' built-in input lag by running `frameCount` frames ahead every frame, displaying the result, then rewinding.
+//
+// Video is disabled for real frames, so the only frame displayed is the last hidden one.
+final class RunAheadController: FrameObserving
+{
+    struct Statistics
+    {
+        var frames = 0
+        var overBudgetFrames = 0 // Frames where run-ahead used more than a frame's duration.
+        
+        var duration = MovingAverage()
+    }
+    
+    static let maximumFrameCount = 4
+    
+    let emulatorCore: EmulatorCore
+    let frameCount: Int
+    
+    var statistics: Statistics {
+        return self.lock.withLock { self._statistics }
+    }
+    private var _statistics = Statistics()
+    
+    private let bridge: RunAheadSupporting
+    
+    private var stateBuffer: UnsafeMutableRawPointer
+    private var stateBufferSize: Int
+    
+    private var isOverBudget = false
+    
+    private let lock = NSLock()
+    
+    init?(emulatorCore: EmulatorCore, frameCount: Int)
+    {
+        guard frameCount > 0, let bridge = emulatorCore.makeRunAheadBridge() else { return nil }
+        
+        self.emulatorCore = emulatorCore
+        self.frameCount = min(frameCount, RunAheadController.maximumFrameCount)
+        self.bridge = bridge
+        
+        // Allocated up front so we never allocate while emulating.
+        self.stateBufferSize = max(bridge.runAheadStateSize, 1)
+        self.stateBuffer = UnsafeMutableRawPointer.allocate(byteCount: self.stateBufferSize, alignment: 16)
+    }
+    
+    deinit
+    {
+        self.stateBuffer.deallocate()
+    }
+    
+    func frameHook(_ frameHook: FrameHook, didEmulateFrameOf emulatorCore: EmulatorCore)
+    {
+        // Running ahead while fast forwarding would multiply cost for no noticeable benefit,
+        // and hidden frames could send duplicate data while playing online.
+        guard emulatorCore.rate <= emulatorCore.deltaCore.supportedRates.lowerBound, !emulatorCore.isWirelessMultiplayerActive else {
+            frameHook.setVideoDisabled(false, by: self)
+            return
+        }
+        
+        self.runAhead(using: frameHook)
+    }
+}
+
+private extension RunAheadController
+{
+    func runAhead(using frameHook: FrameHook)
+    {
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        
+        let stateSize = self.bridge.runAheadStateSize
+        if stateSize > self.stateBufferSize
+        {
+            // State size can change (e.g. N64 expansion pak), so grow buffer if needed.
+            self.stateBuffer.deallocate()
+            
+            self.stateBufferSize = stateSize
+            self.stateBuffer = UnsafeMutableRawPointer.allocate(byteCount: stateSize, alignment: 16)
+        }
+        
+        guard self.bridge.saveRunAheadState(to: self.stateBuffer, size: stateSize) else {
+            // Can't run ahead, so display real frames instead.
+            frameHook.setVideoDisabled(false, by: self)
+            return
+        }
+        
+        for _ in 1 ..< self.frameCount
+        {
+            self.bridge.runHiddenFrame(processVideo: false)
+        }
+        
+        // Only the last frame needs to be displayed.
+        frameHook.presentFrame(by: self) { processVideo in
+            self.bridge.runHiddenFrame(processVideo: processVideo)
+        }
+        
+        guard self.bridge.loadRunAheadState(from: self.stateBuffer, size: stateSize) else {
+            Logger.main.error("Failed to restore state after running ahead.")
+            return
+        }
+        
+        // Next real frame would otherwise display the present, rather than the future.
+        frameHook.setVideoDisabled(true, by: self)
+        
+        let duration = TimeInterval(DispatchTime.now().uptimeNanoseconds - startTime) / TimeInterval(NSEC_PER_SEC)
+        self.record(duration)
+    }
+    
+    func record(_ duration: TimeInterval)
+    {
+        let frameDuration = self.emulatorCore.deltaCore.emulatorBridge.frameDuration
+        
+        let statistics = self.lock.withLock {
+            self._statistics.frames += 1
+            self._statistics.duration.add(duration)
+            
+            if duration > frameDuration
+            {
+                self._statistics.overBudgetFrames += 1
+            }
+            
+            return self._statistics
+        }
+        
+        // Warn once average cost no longer fits within frame budget, since game will start slowing down.
+        let isOverBudget = statistics.frames >= 60 && statistics.duration.value > frameDuration
+        if isOverBudget != self.isOverBudget
+        {
+            self.isOverBudget = isOverBudget
+            
+            if isOverBudget
+            {
+                Logger.main.error("Device can't sustain running \(self.frameCount) frame(s) ahead. Average: \(statistics.duration.value * 1000, format: .fixed(precision: 2))ms, Budget: \(frameDuration * 1000, format: .fixed(precision: 2))ms")
+            }
+        }
+    }
+}
@@ -0,0 +1,289 @@
+//
+//  SaveStateContainer.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import UIKit
+import Compression
+
+import DeltaCore
+
+// Adopted by emulator bridges that can load save states directly from memory,
+// which lets us decompress save state containers without writing a temporary file first.
+// Other cores can still load containers, but they're extracted to a temporary file first.
+@objc(DLTASaveStateDataLoading)
+protocol SaveStateDataLoading: NSObjectProtocol
+{
+    func loadSaveState(from data: Data) throws
+}
+
+// Compressed save state file, consisting of a header followed by the LZ4-compressed save state produced by the emulator core.
+//
+// Header (little-endian):
+//   UInt32 magic, UInt16 version, UInt16 flags, UInt64 uncompressed size,
+//   UInt16 length + UTF-8 core identifier, UInt16 length + UTF-8 core version,
+//   UInt32 length + JPEG thumbnail
+//
+// Version 2 headers have no thumbnail, but are otherwise identical.
+//
+// Files that don't start with magic are raw save states, which are still loaded as-is.
+struct SaveStateContainer
+{
+    static let magic: UInt32 = 0x43535344 // "DSSC"
+    static let currentVersion: UInt16 = 3
+    
+    // Maximum width/height of embedded thumbnail, large enough for save state grid cells.
+    static let thumbnailSize: CGFloat = 512
+    
+    let fileURL: URL
+    let version: UInt16
+    
+    let uncompressedSize: Int
+    
+    let coreIdentifier: String?
+    let coreVersion: String?
+    
+    // Downsampled snapshot, so save states can show thumbnails without decoding full-size imageFileURL.
+    let thumbnailData: Data?
+    var thumbnail: UIImage? {
+        return self.thumbnailData.flatMap { UIImage(data: $0) }
+    }
+    
+    // Offset of compressed save state data.
+    private let payloadOffset: UInt64
+}
+
+extension SaveStateContainer
+{
+    private static let chunkSize = 256 * 1024
+    
+    static func isContainer(at fileURL: URL) -> Bool
+    {
+        guard let fileHandle = try? FileHandle(forReadingFrom: fileURL) else { return false }
+        defer { try? fileHandle.close() }
+        
+        guard let data = try? fileHandle.read(upToCount: MemoryLayout<UInt32>.size), data.count == MemoryLayout<UInt32>.size else { return false }
+        
+        let magic = UInt32(littleEndian: data.withUnsafeBytes { $0.loadUnaligned(as: UInt32.self) })
+        return magic == SaveStateContainer.magic
+    }
+    
+    // Reads header only, without decompressing save state.
+    init(fileURL: URL) throws
+    {
+        let fileHandle = try FileHandle(forReadingFrom: fileURL)
+        defer { try? fileHandle.close() }
+        
+        func read<T: FixedWidthInteger>(_ type: T.Type) throws -> T
+        {
+            guard let data = try fileHandle.read(upToCount: MemoryLayout<T>.size), data.count == MemoryLayout<T>.size else { throw CocoaError(.fileReadCorruptFile) }
+            return T(littleEndian: data.withUnsafeBytes { $0.loadUnaligned(as: T.self) })
+        }
+        
+        func readData(count: Int) throws -> Data?
+        {
+            guard count > 0 else { return nil }
+            
+            guard let data = try fileHandle.read(upToCount: count), data.count == count else { throw CocoaError(.fileReadCorruptFile) }
+            return data
+        }
+        
+        guard try read(UInt32.self) == SaveStateContainer.magic else { throw CocoaError(.fileReadCorruptFile) }
+        
+        let version = try read(UInt16.self)
+        guard version <= SaveStateContainer.currentVersion else { throw CocoaError(.fileReadUnsupportedScheme) }
+        
+        _ = try read(UInt16.self) // Flags, reserved for future use.
+        
+        self.fileURL = fileURL
+        self.version = version
+        self.uncompressedSize = Int(try read(UInt64.self))
+        
+        self.coreIdentifier = try readData(count: Int(try read(UInt16.self))).flatMap { String(data: $0, encoding: .utf8) }
+        self.coreVersion = try readData(count: Int(try read(UInt16.self))).flatMap { String(data: $0, encoding: .utf8) }
+        
+        if version == 2
+        {
+            self.thumbnailData = nil
+        }
+        else
+        {
+            self.thumbnailData = try readData(count: Int(try read(UInt32.self)))
+        }
+        
+        self.payloadOffset = try fileHandle.offset()
+    }
+    
+    // Compresses raw save state at stateFileURL into new container at fileURL, streaming so the save state is never fully in memory.
+    @discardableResult
+    static func write(stateAt stateFileURL: URL, to fileURL: URL, coreIdentifier: String?, coreVersion: String?, snapshot: UIImage?) throws -> SaveStateContainer
+    {
+        let inputHandle = try FileHandle(forReadingFrom: stateFileURL)
+        defer { try? inputHandle.close() }
+        
+        let uncompressedSize = try inputHandle.seekToEnd()
+        try inputHandle.seek(toOffset: 0)
+        
+        // Write to temporary file first so we never leave a partially written container at fileURL.
+        let temporaryURL = fileURL.deletingLastPathComponent().appendingPathComponent(UUID().uuidString)
+        FileManager.default.createFile(atPath: temporaryURL.path, contents: nil)
+        
+        do
+        {
+            let outputHandle = try FileHandle(forWritingTo: temporaryURL)
+            defer { try? outputHandle.close() }
+            
+            var header = Data()
+            
+            func append<T: FixedWidthInteger>(_ value: T)
+            {
+                withUnsafeBytes(of: value.littleEndian) { header.append(contentsOf: $0) }
+            }
+            
+            let coreIdentifierData = Data((coreIdentifier ?? "").utf8)
+            let coreVersionData = Data((coreVersion ?? "").utf8)
+            let thumbnailData = snapshot.flatMap(SaveStateContainer.thumbnailData(for:)) ?? Data()
+            
+            append(SaveStateContainer.magic)
+            append(SaveStateContainer.currentVersion)
+            append(UInt16(0))
+            append(UInt64(uncompressedSize))
+            append(UInt16(coreIdentifierData.count))
+            header.append(coreIdentifierData)
+            append(UInt16(coreVersionData.count))
+            header.append(coreVersionData)
+            append(UInt32(thumbnailData.count))
+            header.append(thumbnailData)
+            
+            try outputHandle.write(contentsOf: header)
+            
+            let filter = try OutputFilter(.compress, using: .lz4) { data in
+                guard let data else { return }
+                try outputHandle.write(contentsOf: data)
+            }
+            
+            while let data = try inputHandle.read(upToCount: SaveStateContainer.chunkSize), !data.isEmpty
+            {
+                try filter.write(data)
+            }
+            
+            try filter.finalize()
+            try outputHandle.synchronize()
+        }
+        catch
+        {
+            try? FileManager.default.removeItem(at: temporaryURL)
+            throw error
+        }
+        
+        if FileManager.default.fileExists(atPath: fileURL.path)
+        {
+            _ = try FileManager.default.replaceItemAt(fileURL, withItemAt: temporaryURL)
+        }
+        else
+        {
+            try FileManager.default.moveItem(at: temporaryURL, to: fileURL)
+        }
+        
+        let container = try SaveStateContainer(fileURL: fileURL)
+        return container
+    }
+    
+    // Decompresses save state into memory.
+    func readState() throws -> Data
+    {
+        var data = Data(capacity: self.uncompressedSize)
+        
+        try self.decompress { chunk in
+            data.append(chunk)
+        }
+        
+        guard data.count == self.uncompressedSize else { throw CocoaError(.fileReadCorruptFile) }
+        return data
+    }
+    
+    // Decompresses save state to raw file, e.g. for cores that can only load save states from files.
+    func extractState(to fileURL: URL) throws
+    {
+        FileManager.default.createFile(atPath: fileURL.path, contents: nil)
+        
+        let outputHandle = try FileHandle(forWritingTo: fileURL)
+        defer { try? outputHandle.close() }
+        
+        var size = 0
+        try self.decompress { chunk in
+            try outputHandle.write(contentsOf: chunk)
+            size += chunk.count
+        }
+        
+        guard size == self.uncompressedSize else { throw CocoaError(.fileReadCorruptFile) }
+    }
+}
+
+private extension SaveStateContainer
+{
+    static func thumbnailData(for snapshot: UIImage) -> Data?
+    {
+        let scale = min(SaveStateContainer.thumbnailSize / max(snapshot.size.width, snapshot.size.height), 1.0)
+        let size = CGSize(width: (snapshot.size.width * scale).rounded(), height: (snapshot.size.height * scale).rounded())
+        
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1.0
+        format.opaque = true
+        
+        let renderer = UIGraphicsImageRenderer(size: size, format: format)
+        let data = renderer.jpegData(withCompressionQuality: 0.8) { context in
+            snapshot.draw(in: CGRect(origin: .zero, size: size))
+        }
+        
+        return data
+    }
+    
+    func decompress(_ handler: (Data) throws -> Void) throws
+    {
+        let inputHandle = try FileHandle(forReadingFrom: self.fileURL)
+        defer { try? inputHandle.close() }
+        
+        try inputHandle.seek(toOffset: self.payloadOffset)
+        
+        let filter = try InputFilter(.decompress, using: .lz4) { (length: Int) -> Data? in
+            try inputHandle.read(upToCount: length)
+        }
+        
+        while let data = try filter.readData(ofLength: SaveStateContainer.chunkSize), !data.isEmpty
+        {
+            try handler(data)
+        }
+    }
+}
+
+extension EmulatorCore
+{
+    // Loads both raw save states and save state containers.
+    func loadSaveState(_ saveState: SaveStateProtocol) throws
+    {
+        guard SaveStateContainer.isContainer(at: saveState.fileURL) else { return try self.load(saveState) }
+        
+        let container = try SaveStateContainer(fileURL: saveState.fileURL)
+        
+        if let emulatorBridge = self.deltaCore.emulatorBridge as? SaveStateDataLoading
+        {
+            let data = try container.readState()
+            try emulatorBridge.loadSaveState(from: data)
+        }
+        else
+        {
+            // DeltaCore can otherwise only load save states from files.
+            let temporaryURL = FileManager.default.uniqueTemporaryURL()
+            defer { try? FileManager.default.removeItem(at: temporaryURL) }
+            
+            try container.extractState(to: temporaryURL)
+            
+            let temporarySaveState = DeltaCore.SaveState(fileURL: temporaryURL, gameType: saveState.gameType)
+            try self.load(temporarySaveState)
+        }
+    }
+}
@@ -0,0 +1,152 @@
+//
+//  SaveStateRunAheadAdapter.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+// Implements RunAheadSupporting for emulator bridges that don't natively support it, using their regular file-based save states.
+// Supported systems have small save states that are written synchronously, so they remain in the file system cache
+// and saving + loading them every frame is fast enough for run-ahead and rewinding.
+final class SaveStateRunAheadAdapter: NSObject, RunAheadSupporting
+{
+    let emulatorBridge: EmulatorBridging
+    
+    private let fileURL: URL
+    private var stateSize: Int?
+    
+    init(emulatorBridge: EmulatorBridging)
+    {
+        self.emulatorBridge = emulatorBridge
+        self.fileURL = FileManager.default.uniqueTemporaryURL()
+    }
+    
+    deinit
+    {
+        try? FileManager.default.removeItem(at: self.fileURL)
+    }
+    
+    static func isSupported(by system: System) -> Bool
+    {
+        switch system
+        {
+        case .nes, .snes, .gbc, .gba, .genesis: return true
+        case .n64: return false // Writes save states asynchronously.
+        case .ds: return false // Save states are too large to write every frame.
+        }
+    }
+    
+    var runAheadStateSize: Int {
+        if let stateSize = self.stateSize
+        {
+            return stateSize
+        }
+        
+        // Save once to determine size.
+        self.emulatorBridge.saveSaveState(to: self.fileURL)
+        
+        let stateSize = (try? FileManager.default.attributesOfItem(atPath: self.fileURL.path)[.size] as? Int) ?? 0
+        self.stateSize = stateSize
+        return stateSize
+    }
+    
+    func saveRunAheadState(to buffer: UnsafeMutableRawPointer, size: Int) -> Bool
+    {
+        self.emulatorBridge.saveSaveState(to: self.fileURL)
+        
+        let fileDescriptor = open(self.fileURL.path, O_RDONLY)
+        guard fileDescriptor >= 0 else { return false }
+        defer { close(fileDescriptor) }
+        
+        var fileStatus = stat()
+        guard fstat(fileDescriptor, &fileStatus) == 0 else { return false }
+        
+        let fileSize = Int(fileStatus.st_size)
+        guard fileSize == size else {
+            // State size changed, so caller must resize its buffer first.
+            self.stateSize = fileSize
+            return false
+        }
+        
+        // Read directly into caller's buffer, rather than allocating Data every frame.
+        var offset = 0
+        while offset < size
+        {
+            let count = read(fileDescriptor, buffer + offset, size - offset)
+            guard count > 0 else { return false }
+            
+            offset += count
+        }
+        
+        return true
+    }
+    
+    func loadRunAheadState(from buffer: UnsafeRawPointer, size: Int) -> Bool
+    {
+        let fileDescriptor = open(self.fileURL.path, O_WRONLY | O_CREAT | O_TRUNC, 0o600)
+        guard fileDescriptor >= 0 else { return false }
+        
+        var offset = 0
+        while offset < size
+        {
+            let count = write(fileDescriptor, buffer + offset, size - offset)
+            guard count > 0 else { break }
+            
+            offset += count
+        }
+        
+        close(fileDescriptor)
+        guard offset == size else { return false }
+        
+        do
+        {
+            try self.emulatorBridge.loadSaveState(from: self.fileURL)
+            return true
+        }
+        catch
+        {
+            Logger.main.error("Failed to load run-ahead state. \(error.localizedDescription, privacy: .public)")
+            return false
+        }
+    }
+    
+    func runHiddenFrame(processVideo: Bool)
+    {
+        // Without an audio renderer, bridges drop this frame's audio instead of playing it faster than real-time.
+        let audioRenderer = self.emulatorBridge.audioRenderer
+        self.emulatorBridge.audioRenderer = nil
+        defer { self.emulatorBridge.audioRenderer = audioRenderer }
+        
+        self.emulatorBridge.runFrame(processVideo: processVideo)
+    }
+}
+
+extension System
+{
+    // Whether run-ahead and rewinding can be used with this system's emulator core.
+    var supportsRunAhead: Bool {
+        return self.deltaCore.emulatorBridge is RunAheadSupporting || SaveStateRunAheadAdapter.isSupported(by: self)
+    }
+}
+
+extension EmulatorCore
+{
+    // Emulator bridge itself if it natively supports RunAheadSupporting, otherwise a SaveStateRunAheadAdapter if possible.
+    func makeRunAheadBridge() -> RunAheadSupporting?
+    {
+        if let bridge = self.deltaCore.emulatorBridge as? RunAheadSupporting
+        {
+            return bridge
+        }
+        
+        guard let system = System(gameType: self.deltaCore.gameType), SaveStateRunAheadAdapter.isSupported(by: system) else { return nil }
+        
+        let adapter = SaveStateRunAheadAdapter(emulatorBridge: self.deltaCore.emulatorBridge)
+        return adapter
+    }
+}
@@ -44,10 +44,29 @@ struct ExperimentalFeatures: FeatureContainer
              options: SkinDebuggingOptions())
     var skinDebugging
     
+    @Feature(name: "Compressed Save States",
+             description: "Compress new save states to reduce their size, which also speeds up syncing and Handoff. Compressed save states can't be loaded by older versions of Delta.")
+    var compressedSaveStates
+    
+    @Feature(name: "Rewind",
+             description: "Hold the Rewind button to go back in time. Rewind history is kept in memory, and is only supported by some systems.",
+             options: RewindOptions())
+    var rewind
+    
+    @Feature(name: "Auto Save Checkpoints",
+             description: "Periodically auto save while playing instead of only when pausing, and keep more auto save states per game.",
+             options: AutoSaveOptions())
+    var autoSaveCheckpoints
+    
     @Feature(name: "Reverse Controller Skin Screens",
              description: "Dynamically reverse the order of screen inputFrames in controller skins. Can be used to “flip” between DS screens.")
     var reverseScreens
     
+    @Feature(name: "Performance HUD",
+             description: "Show frame times, emulation speed, and audio buffer levels while playing. Long-press the HUD to export a trace of recent frames as JSON or CSV. Requires iOS 18 or later.",
+             options: PerformanceHUDOptions())
+    var performanceHUD
+    
     @Feature(name: "Show Touches",
              description: "Visually show touches. Useful for screen recordings and tutorials.")
     var showTouches
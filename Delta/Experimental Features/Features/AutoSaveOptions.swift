@@ -0,0 +1,30 @@
+//
+//  AutoSaveOptions.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import SwiftUI
+
+import DeltaFeatures
+
+struct AutoSaveOptions
+{
+    @Option(name: "Auto Save Slots", description: "Number of auto save states to keep per game. The least recently saved one is replaced once all slots are used.", detailView: { slotCount in
+        HStack {
+            Text("Auto Save Slots: \(Int(slotCount.wrappedValue))")
+            Slider(value: slotCount, in: 2...10, step: 1).displayInline()
+        }
+    })
+    var slotCount: Double = 4
+    
+    @Option(name: "Checkpoint Interval", description: "How often to auto save while playing. If Delta quits unexpectedly, you'll lose at most this much progress.", detailView: { checkpointInterval in
+        HStack {
+            Text("Checkpoint Interval: \(Int(checkpointInterval.wrappedValue)) min")
+            Slider(value: checkpointInterval, in: 1...15, step: 1).displayInline()
+        }
+    })
+    var checkpointInterval: Double = 5
+}
@@ -0,0 +1,15 @@
+//
+//  PerformanceHUDOptions.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import DeltaFeatures
+
+struct PerformanceHUDOptions
+{
+    @Option(name: "Show Frame Graph", description: "Show a graph of recent frame times. Frames that took too long are shown in red.")
+    var showsFrameGraph: Bool = true
+}
@@ -0,0 +1,30 @@
+//
+//  RewindOptions.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import SwiftUI
+
+import DeltaFeatures
+
+struct RewindOptions
+{
+    @Option(name: "Memory Limit", description: "Maximum memory used to store rewind history. More memory allows rewinding further back.", detailView: { memoryLimit in
+        HStack {
+            Text("Memory Limit: \(Int(memoryLimit.wrappedValue))MB")
+            Slider(value: memoryLimit, in: 8...128, step: 8).displayInline()
+        }
+    })
+    var memoryLimit: Double = 32
+    
+    @Option(name: "Snapshots Per Second", description: "How often to save rewind history. Higher values rewind more smoothly, but use more memory and CPU.", detailView: { snapshotsPerSecond in
+        HStack {
+            Text("Snapshots Per Second: \(Int(snapshotsPerSecond.wrappedValue))")
+            Slider(value: snapshotsPerSecond, in: 1...10, step: 1).displayInline()
+        }
+    })
+    var snapshotsPerSecond: Double = 4
+}
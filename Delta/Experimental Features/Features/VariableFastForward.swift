@@ -94,6 +94,9 @@ struct VariableFastForwardOptions
     
     @Option(name: "Allow Unrestricted Speeds", description: "Allow choosing speeds that exceed the maximum supported speed of a system.\n\nThis can be used to test the performance of new iOS devices.")
     var allowUnrestrictedSpeeds: Bool = false
+    
+    @Option(name: "Adaptive Speed", description: "Start fast forwarding at a lower speed, then speed up to your preferred speed for as long as your device can keep up. The speed actually reached is shown when fast forward is disabled.")
+    var isAdaptive: Bool = false
 }
 
 extension Feature where Options == VariableFastForwardOptions
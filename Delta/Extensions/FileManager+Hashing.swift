@@ -0,0 +1,124 @@
+//
+//  FileManager+Hashing.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+
+extension FileManager
+{
+    // Large enough to amortize syscall overhead, small enough that concurrent imports don't balloon memory.
+    static let hashingChunkSize = 4 * 1024 * 1024
+    
+    func sha1Hash(ofItemAt fileURL: URL) throws -> String
+    {
+        let fileHandle = try FileHandle(forReadingFrom: fileURL)
+        defer { try? fileHandle.close() }
+        
+        var hasher = Insecure.SHA1()
+        
+        while let data = try autoreleasepool(invoking: { try fileHandle.read(upToCount: FileManager.hashingChunkSize) }), !data.isEmpty
+        {
+            hasher.update(data: data)
+        }
+        
+        return hasher.finalize().hexString
+    }
+    
+    func sha256Hash(ofItemAt fileURL: URL) throws -> String
+    {
+        let fileHandle = try FileHandle(forReadingFrom: fileURL)
+        defer { try? fileHandle.close() }
+        
+        var hasher = SHA256()
+        
+        while let data = try autoreleasepool(invoking: { try fileHandle.read(upToCount: FileManager.hashingChunkSize) }), !data.isEmpty
+        {
+            hasher.update(data: data)
+        }
+        
+        return hasher.finalize().hexString
+    }
+    
+    /// Returns whether moving `fileURL` into `directoryURL` is just a rename, rather than a copy to another volume.
+    func isItem(at fileURL: URL, onSameVolumeAs directoryURL: URL) -> Bool
+    {
+        guard let sourceVolume = try? fileURL.resourceValues(forKeys: [.volumeIdentifierKey]).volumeIdentifier,
+              let destinationVolume = try? directoryURL.resourceValues(forKeys: [.volumeIdentifierKey]).volumeIdentifier
+        else { return true }
+        
+        return sourceVolume.isEqual(destinationVolume)
+    }
+    
+    /// Moves the item at `fileURL` to `destinationURL`, unless an item already exists there, in which case the existing item is kept and `fileURL` is removed.
+    ///
+    /// Returns whether the item was moved. Destinations are content-addressed, so another import winning the race to create `destinationURL` is not an error.
+    func moveItemIfNeeded(at fileURL: URL, to destinationURL: URL) throws -> Bool
+    {
+        if !self.fileExists(atPath: destinationURL.path)
+        {
+            do
+            {
+                try self.moveItem(at: fileURL, to: destinationURL)
+                return true
+            }
+            catch CocoaError.fileWriteFileExists
+            {
+                // Created by another import after we checked, so fall through and remove ours.
+            }
+        }
+        
+        try self.removeItem(at: fileURL)
+        return false
+    }
+    
+    /// Writes the data passed to `write` by `contents` into `directoryURL`, naming it `<sha1>.<pathExtension>`, and returns its SHA-1 hash.
+    ///
+    /// Data is hashed as it is written, so callers can stream arbitrarily large contents (e.g. archive entries) without buffering them.
+    /// If a file with the same hash already exists in `directoryURL`, the existing file is kept and `isNewItem` is false.
+    func writeItemNamedBySHA1Hash(toDirectory directoryURL: URL, pathExtension: String, contents: (_ write: (Data) throws -> Void) throws -> Void) throws -> (sha1Hash: String, isNewItem: Bool)
+    {
+        // Write to a hidden file in the destination directory so the final move is just a rename.
+        let temporaryURL = directoryURL.appendingPathComponent("." + UUID().uuidString)
+        defer { try? self.removeItem(at: temporaryURL) }
+        
+        guard self.createFile(atPath: temporaryURL.path, contents: nil) else { throw CocoaError(.fileWriteUnknown, userInfo: [NSURLErrorKey: temporaryURL]) }
+        
+        let outputHandle = try FileHandle(forWritingTo: temporaryURL)
+        
+        var hasher = Insecure.SHA1()
+        
+        do
+        {
+            try contents { (data) in
+                hasher.update(data: data)
+                try outputHandle.write(contentsOf: data)
+            }
+            
+            try outputHandle.close()
+        }
+        catch
+        {
+            try? outputHandle.close()
+            throw error
+        }
+        
+        let sha1Hash = hasher.finalize().hexString
+        
+        let destinationURL = directoryURL.appendingPathComponent(sha1Hash).appendingPathExtension(pathExtension)
+        
+        let isNewItem = try self.moveItemIfNeeded(at: temporaryURL, to: destinationURL)
+        return (sha1Hash, isNewItem)
+    }
+}
+
+extension Digest
+{
+    var hexString: String {
+        return self.map { String(format: "%02x", $0) }.joined()
+    }
+}
@@ -28,3 +28,17 @@ extension NSUserActivity
         ]
     }
 }
+
+// Sent by receiving device when continuing Handoff to request save state.
+// Older versions of Delta don't send this, in which case we fall back to legacy format.
+struct HandoffSaveStateRequest: Codable
+{
+    var supportsChunks: Bool
+    var supportsCompression: Bool
+    
+    // Chosen by receiving device, and reused when retrying an interrupted transfer so sender can resume sending the same save state.
+    var transferID: UUID?
+    
+    // Number of verified bytes receiving device already has from a previous attempt with the same transferID.
+    var offset: Int?
+}
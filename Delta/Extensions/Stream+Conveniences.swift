@@ -8,6 +8,123 @@
 
 import Foundation
 
+import ZIPFoundation
+
+// Files are streamed as a series of chunks, each prefixed with StreamChunk.magic + a StreamChunk.Header, followed by an empty chunk to mark the end.
+// StreamChunk.magic is never a plausible size for the legacy (Int32 length-prefixed) format, so receivers can transparently support both.
+//
+// Each header also includes the chunk's offset within the file and the total file size, so receivers can detect missing or truncated chunks,
+// and senders can resume interrupted transfers from any offset the receiver has already verified.
+struct StreamChunk
+{
+    struct Flags: OptionSet
+    {
+        let rawValue: UInt32
+        
+        static let compressed = Flags(rawValue: 1 << 0)
+    }
+    
+    struct Header
+    {
+        static let size = 4 * MemoryLayout<UInt32>.size + 2 * MemoryLayout<UInt64>.size
+        
+        var flags: Flags
+        
+        var payloadSize: Int // Size as sent over stream (possibly compressed).
+        var originalSize: Int
+        
+        var checksum: UInt32 // CRC32 of uncompressed data.
+        
+        var offset: Int // Offset of chunk's uncompressed data within file.
+        var fileSize: Int
+    }
+    
+    static let magic: UInt32 = 0x44534332 // "DSC2"
+    static let maximumSize = 1024 * 1024 // 1MB
+    
+    var header: Header
+    var payload: Data
+}
+
+extension StreamChunk
+{
+    init(data: Data, offset: Int, fileSize: Int, compress: Bool)
+    {
+        let checksum = data.crc32(checksum: 0)
+        
+        // Only send compressed data if it's actually smaller.
+        if compress, let compressedData = try? (data as NSData).compressed(using: .lzfse) as Data, compressedData.count < data.count
+        {
+            self.header = Header(flags: .compressed, payloadSize: compressedData.count, originalSize: data.count, checksum: checksum, offset: offset, fileSize: fileSize)
+            self.payload = compressedData
+        }
+        else
+        {
+            self.header = Header(flags: [], payloadSize: data.count, originalSize: data.count, checksum: checksum, offset: offset, fileSize: fileSize)
+            self.payload = data
+        }
+    }
+    
+    static func end(fileSize: Int) -> StreamChunk
+    {
+        let header = Header(flags: [], payloadSize: 0, originalSize: 0, checksum: 0, offset: fileSize, fileSize: fileSize)
+        return StreamChunk(header: header, payload: Data())
+    }
+    
+    func decodedData() throws -> Data
+    {
+        let data: Data
+        
+        if self.header.flags.contains(.compressed)
+        {
+            data = try (self.payload as NSData).decompressed(using: .lzfse) as Data
+        }
+        else
+        {
+            data = self.payload
+        }
+        
+        guard data.count == self.header.originalSize, data.crc32(checksum: 0) == self.header.checksum else { throw CocoaError(.fileReadCorruptFile) }
+        return data
+    }
+}
+
+extension StreamChunk.Header
+{
+    init(data: Data)
+    {
+        func value<T: FixedWidthInteger>(at offset: Int, as type: T.Type) -> T
+        {
+            let value = data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: T.self) }
+            return T(littleEndian: value)
+        }
+        
+        self.flags = StreamChunk.Flags(rawValue: value(at: 0, as: UInt32.self))
+        self.payloadSize = Int(value(at: 4, as: UInt32.self))
+        self.originalSize = Int(value(at: 8, as: UInt32.self))
+        self.checksum = value(at: 12, as: UInt32.self)
+        self.offset = Int(value(at: 16, as: UInt64.self))
+        self.fileSize = Int(value(at: 24, as: UInt64.self))
+    }
+    
+    func data() -> Data
+    {
+        var data = Data(capacity: StreamChunk.Header.size)
+        
+        for value in [self.flags.rawValue, UInt32(self.payloadSize), UInt32(self.originalSize), self.checksum]
+        {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+        
+        for value in [UInt64(self.offset), UInt64(self.fileSize)]
+        {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+        
+        return data
+    }
+}
+
 extension OutputStream
 {
     func send<T: Encodable>(_ payload: T) async throws
@@ -27,18 +144,55 @@ extension OutputStream
         try await self.send(requestData)
     }
     
-    private func send(_ data: Data) async throws
+    // Starts sending from offset (e.g. when resuming an interrupted transfer), skipping data receiver already has.
+    func sendFile(at fileURL: URL, offset: Int = 0, compress: Bool, progress: Progress? = nil) async throws
     {
-        var data = data
+        let fileHandle = try FileHandle(forReadingFrom: fileURL)
+        defer { try? fileHandle.close() }
         
-        while !data.isEmpty
+        let fileSize = Int(try fileHandle.seekToEnd())
+        var offset = min(max(offset, 0), fileSize)
+        
+        try fileHandle.seek(toOffset: UInt64(offset))
+        
+        progress?.totalUnitCount = Int64(fileSize)
+        progress?.completedUnitCount = Int64(offset)
+        
+        while let data = try fileHandle.read(upToCount: StreamChunk.maximumSize), !data.isEmpty
         {
-            let size = data.count
-            try data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
-                let writtenBytes = self.write(bytes.baseAddress!, maxLength: size)
-                guard writtenBytes >= 0 else { throw CocoaError(.fileReadUnknown) }
+            let chunk = StreamChunk(data: data, offset: offset, fileSize: fileSize, compress: compress)
+            try await self.send(chunk)
+            
+            offset += data.count
+            progress?.completedUnitCount = Int64(offset)
+        }
+        
+        try await self.send(StreamChunk.end(fileSize: fileSize))
+    }
+}
+
+private extension OutputStream
+{
+    func send(_ chunk: StreamChunk) async throws
+    {
+        let magicData = withUnsafeBytes(of: StreamChunk.magic.littleEndian) { Data($0) }
+        try await self.send(magicData + chunk.header.data())
+        try await self.send(chunk.payload)
+    }
+    
+    func send(_ data: Data) async throws
+    {
+        try data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            guard let baseAddress = bytes.baseAddress else { return }
+            
+            // Advance offset after partial writes rather than removing written bytes from data, which copies remaining bytes each time.
+            var offset = 0
+            while offset < bytes.count
+            {
+                let writtenBytes = self.write(baseAddress + offset, maxLength: bytes.count - offset)
+                guard writtenBytes > 0 else { throw self.streamError ?? CocoaError(.fileWriteUnknown) }
                 
-                data.replaceSubrange(0 ..< writtenBytes, with: Data())
+                offset += writtenBytes
             }
         }
     }
@@ -46,32 +200,154 @@ extension OutputStream
 
 extension InputStream
 {
-    private func receiveData(expectedSize: Int) async throws -> Data
+    func receive<T: Decodable>() async throws -> T
+    {
+        let size = MemoryLayout<Int32>.size
+        let expectedSizeData = try await self.receiveData(expectedSize: size)
+        
+        let expectedSize = Int(expectedSizeData.withUnsafeBytes { $0.load(as: Int32.self) })
+        let data = try await self.receiveData(expectedSize: expectedSize)
+        
+        return try self.decode(data)
+    }
+    
+    // Returns nil if no bytes become available before timeout.
+    func receive<T: Decodable>(timeout: TimeInterval) async throws -> T?
     {
-        var data = Data()
+        let deadline = Date().addingTimeInterval(timeout)
+        
+        while !self.hasBytesAvailable
+        {
+            guard Date() < deadline, self.streamStatus == .open else { return nil }
+            try await Task.sleep(nanoseconds: 10 * NSEC_PER_MSEC)
+        }
+        
+        let payload: T = try await self.receive()
+        return payload
+    }
+    
+    // Supports both chunked + legacy formats. Throws if any chunk is corrupted, out of order, or missing.
+    // Chunks are only written once verified, so if transfer is interrupted, fileURL's size is the offset to resume from.
+    // If offset is 0, replaces any existing file at fileURL. Otherwise, appends to the first offset bytes of fileURL.
+    func receiveFile(to fileURL: URL, offset: Int = 0, progress: Progress? = nil) async throws
+    {
+        var prefix = try await self.receiveUInt32()
+        
+        guard prefix == StreamChunk.magic else {
+            // Legacy format, so prefix is size of remaining data.
+            let expectedSize = Int(Int32(bitPattern: prefix))
+            guard expectedSize >= 0 else { throw CocoaError(.fileReadCorruptFile) }
+            
+            progress?.totalUnitCount = Int64(expectedSize)
+            
+            let data = try await self.receiveData(expectedSize: expectedSize)
+            try data.write(to: fileURL, options: .atomic)
+            
+            progress?.completedUnitCount = Int64(expectedSize)
+            return
+        }
+        
+        if offset == 0
+        {
+            guard FileManager.default.createFile(atPath: fileURL.path, contents: nil) else { throw CocoaError(.fileWriteUnknown, userInfo: [NSURLErrorKey: fileURL]) }
+        }
+        
+        let fileHandle = try FileHandle(forWritingTo: fileURL)
+        defer { try? fileHandle.close() }
+        
+        // Also positions file handle at offset.
+        try fileHandle.truncate(atOffset: UInt64(offset))
         
-        while data.count < expectedSize
+        var fileSize = offset
+        var isFirstChunk = true
+        
+        // Reused for every chunk to avoid allocating a new buffer each time.
+        var buffer = Data(count: StreamChunk.maximumSize)
+        
+        while true
         {
-            var chunkData = Data(count: 1024) // 1KB
-            let size = chunkData.withUnsafeMutableBytes { (mutableBytes: UnsafeMutableRawBufferPointer) in
-                self.read(mutableBytes.baseAddress!, maxLength: min(expectedSize, 1024))
+            guard prefix == StreamChunk.magic else { throw CocoaError(.fileReadCorruptFile) }
+            
+            let headerData = try await self.receiveData(expectedSize: StreamChunk.Header.size)
+            let header = StreamChunk.Header(data: headerData)
+            
+            if isFirstChunk && header.offset == 0 && fileSize > 0
+            {
+                // Sender couldn't resume (e.g. it no longer has the same save state), so start over.
+                try fileHandle.truncate(atOffset: 0)
+                fileSize = 0
+            }
+            
+            isFirstChunk = false
+            
+            // Chunks must be contiguous with what we've already received.
+            guard header.offset == fileSize, header.payloadSize <= buffer.count else { throw CocoaError(.fileReadCorruptFile) }
+            
+            progress?.totalUnitCount = Int64(header.fileSize)
+            progress?.completedUnitCount = Int64(fileSize)
+            
+            guard header.payloadSize > 0 else {
+                // End of stream.
+                guard fileSize == header.fileSize else { throw CocoaError(.fileReadCorruptFile) }
+                break
             }
             
-            guard size > 0 else { throw CocoaError(.xpcConnectionInterrupted) }
-            data += chunkData[0 ..< size]
+            try buffer.withUnsafeMutableBytes { (bytes: UnsafeMutableRawBufferPointer) in
+                try self.read(into: UnsafeMutableRawBufferPointer(rebasing: bytes[0 ..< header.payloadSize]))
+            }
+            
+            let chunk = StreamChunk(header: header, payload: buffer[0 ..< header.payloadSize])
+            let data = try chunk.decodedData()
+            
+            try fileHandle.write(contentsOf: data)
+            
+            fileSize += data.count
+            progress?.completedUnitCount = Int64(fileSize)
+            
+            prefix = try await self.receiveUInt32()
+        }
+    }
+}
+
+private extension InputStream
+{
+    func receiveData(expectedSize: Int) async throws -> Data
+    {
+        // Read directly into final buffer, rather than appending separately allocated chunks.
+        var data = Data(count: expectedSize)
+        try data.withUnsafeMutableBytes { (bytes: UnsafeMutableRawBufferPointer) in
+            try self.read(into: bytes)
         }
         
         return data
     }
     
-    func receive<T: Decodable>() async throws -> T
+    // Either StreamChunk.magic or legacy Int32 size prefix, both sent little-endian.
+    func receiveUInt32() async throws -> UInt32
     {
-        let size = MemoryLayout<Int32>.size
-        let expectedSizeData = try await self.receiveData(expectedSize: size)
+        let data = try await self.receiveData(expectedSize: MemoryLayout<UInt32>.size)
         
-        let expectedSize = Int(expectedSizeData.withUnsafeBytes { $0.load(as: Int32.self) })
-        let data = try await self.receiveData(expectedSize: expectedSize)
+        let value = data.withUnsafeBytes { $0.loadUnaligned(as: UInt32.self) }
+        return UInt32(littleEndian: value)
+    }
+    
+    // Fills entire buffer, throwing if stream ends first.
+    func read(into buffer: UnsafeMutableRawBufferPointer) throws
+    {
+        guard let baseAddress = buffer.baseAddress else { return }
         
+        var offset = 0
+        while offset < buffer.count
+        {
+            let size = self.read(baseAddress.advanced(by: offset).assumingMemoryBound(to: UInt8.self), maxLength: buffer.count - offset)
+            guard size > 0 else { throw self.streamError ?? CocoaError(.xpcConnectionInterrupted) }
+            
+            offset += size
+        }
+    }
+    
+    func decode<T: Decodable>(_ data: Data) throws -> T
+    {
         if let data = data as? T
         {
             return data
@@ -185,6 +185,9 @@ extension GameCollectionViewController
 
         self.collectionView?.dataSource = self.dataSource
         self.collectionView?.prefetchDataSource = self.dataSource
+        
+        // ThumbnailCache caches thumbnails under a memory budget, so only keep enough here for visible + prefetched cells.
+        self.dataSource.prefetchItemCache.countLimit = 100
         self.collectionView?.delegate = self
         
         if UIApplication.shared.supportsMultipleScenes
@@ -330,7 +333,7 @@ extension GameCollectionViewController
                 
                 do
                 {
-                    try destinationViewController.emulatorCore?.load(saveState)
+                    try destinationViewController.emulatorCore?.loadSaveState(saveState)
                 }
                 catch EmulatorCore.SaveStateError.doesNotExist
                 {
@@ -373,7 +376,7 @@ extension GameCollectionViewController
         {
             let fetchRequest = SaveState.rst_fetchRequest() as! NSFetchRequest<SaveState>
             fetchRequest.predicate = NSPredicate(format: "%K == %@ AND %K == %d", #keyPath(SaveState.game), game, #keyPath(SaveState.type), SaveStateType.auto.rawValue)
-            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.creationDate), ascending: true)]
+            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.modifiedDate), ascending: true)]
             
             do
             {
@@ -458,10 +461,14 @@ private extension GameCollectionViewController
             self?.configure(cell as! GridCollectionViewCell, for: indexPath)
         }
         
-        self.dataSource.prefetchHandler = { (game, indexPath, completionHandler) in
-            guard let artworkURL = game.artworkURL else { return nil }
+        self.dataSource.prefetchHandler = { [weak self] (game, indexPath, completionHandler) in
+            guard let self, let artworkURL = game.artworkURL else { return nil }
+            
+            // Decode artwork at the size it's displayed to keep memory flat regardless of library size.
+            let layout = self.collectionViewLayout as! GridCollectionViewLayout
+            let maximumPixelSize = layout.itemWidth * self.traitCollection.displayScale
             
-            let imageOperation = LoadImageURLOperation(url: artworkURL)
+            let imageOperation = LoadImageURLOperation(url: artworkURL, maximumPixelSize: maximumPixelSize)
             imageOperation.resultHandler = { (image, error) in
                 completionHandler(image, error)
             }
@@ -610,7 +617,7 @@ private extension GameCollectionViewController
                         {
                             let fetchRequest = SaveState.rst_fetchRequest() as! NSFetchRequest<SaveState>
                             fetchRequest.predicate = NSPredicate(format: "%K == %@ AND %K == %d", #keyPath(SaveState.game), game, #keyPath(SaveState.type), SaveStateType.auto.rawValue)
-                            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.creationDate), ascending: true)]
+                            fetchRequest.sortDescriptors = [NSSortDescriptor(key: #keyPath(SaveState.modifiedDate), ascending: true)]
                             
                             do
                             {
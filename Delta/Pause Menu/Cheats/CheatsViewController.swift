@@ -157,7 +157,7 @@ private extension CheatsViewController
         Task {
             do
             {
-                let cheatBase = try CheatBase()
+                let cheatBase = try await CheatBase.database()
                 let cheats = try await cheatBase.cheats(for: self.game) ?? []
                 self.cheatBaseCheats = cheats
                 
@@ -163,6 +163,9 @@ extension SaveStatesViewController
         self.collectionView?.dataSource = self.dataSource
         self.collectionView?.prefetchDataSource = self.dataSource
         
+        // ThumbnailCache caches thumbnails under a memory budget, so only keep enough here for visible + prefetched cells.
+        self.dataSource.prefetchItemCache.countLimit = 100
+        
         switch self.mode
         {
         case .saving:
@@ -307,18 +310,23 @@ private extension SaveStatesViewController
         }
         
         self.dataSource.prefetchHandler = { [unowned self] (saveState, indexPath, completionHandler) in
-            let imageOperation = LoadImageURLOperation(url: saveState.imageFileURL)
-            imageOperation.resultHandler = { (image, error) in
-                completionHandler(image, error)
-            }
-                        
-            if self.isAppearing
+            let collectionViewLayout = self.collectionViewLayout as! GridCollectionViewLayout
+            let maximumPixelSize = collectionViewLayout.itemWidth * self.traitCollection.displayScale
+            
+            if self.isAppearing, let thumbnail = ThumbnailCache.shared.cachedThumbnail(forImageAt: saveState.imageFileURL, maximumPixelSize: maximumPixelSize)
             {
-                imageOperation.start()
-                imageOperation.waitUntilFinished()
+                // Show cached thumbnails immediately to avoid flashing empty cells while appearing.
+                // Uncached thumbnails are still decoded in background, rather than blocking main thread to decode full-size images.
+                completionHandler(thumbnail, nil)
                 return nil
             }
             
+            // Compressed save states embed a small thumbnail, which is cheaper to decode than the full-size snapshot.
+            let imageOperation = LoadSaveStateThumbnailOperation(saveState: saveState, maximumPixelSize: maximumPixelSize)
+            imageOperation.resultHandler = { (image, error) in
+                completionHandler(image, error)
+            }
+            
             return imageOperation
         }
         
@@ -857,7 +865,7 @@ private extension SaveStatesViewController
                 throw error
             }
             
-            try FileManager.default.copyItem(at: fileURL, to: saveState.fileURL, shouldReplace: true)
+            try DatabaseManager.shared.saveStateBlobStore.storeItem(at: fileURL, to: saveState.fileURL, move: false)
             SyncManager.shared.recordController?.updateRecord(for: saveState)
         }
         catch
@@ -1103,7 +1111,7 @@ private extension SaveStatesViewController
         {
             do
             {
-                try emulatorCore.load(saveState)
+                try emulatorCore.loadSaveState(saveState)
             }
             catch EmulatorCore.SaveStateError.doesNotExist
             {
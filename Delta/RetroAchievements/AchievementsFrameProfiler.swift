@@ -0,0 +1,116 @@
+//
+//  AchievementsFrameProfiler.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+// Records how long achievement processing takes each frame, and decides how often achievements should be evaluated
+// so that sets with heavy rich presence or leaderboard logic don't push emulation over its frame budget.
+struct AchievementsFrameProfiler
+{
+    struct Sample
+    {
+        var duration: TimeInterval
+        var memoryStatistics: AchievementsTracker.MemoryStatistics
+    }
+    
+    struct Percentiles
+    {
+        var p50: TimeInterval
+        var p95: TimeInterval
+        var p99: TimeInterval
+        
+        var averagePeeks: Double
+        var averageBytesRead: Double
+    }
+    
+    static let windowSize = 300 // ~5 seconds at 60fps
+    static let maximumFrameInterval = 4
+    
+    // Fraction of each frame's duration achievement processing may use before we start skipping frames.
+    var budgetFraction: Double = 0.25
+    
+    // Achievements are evaluated every frameInterval frames.
+    private(set) var frameInterval = 1
+    
+    private var samples = [Sample]()
+    private var nextSampleIndex = 0
+    private var samplesSinceAdjustment = 0
+    
+    init()
+    {
+        self.samples.reserveCapacity(AchievementsFrameProfiler.windowSize)
+    }
+    
+    mutating func record(_ sample: Sample)
+    {
+        if self.samples.count < AchievementsFrameProfiler.windowSize
+        {
+            self.samples.append(sample)
+        }
+        else
+        {
+            self.samples[self.nextSampleIndex] = sample
+        }
+        
+        self.nextSampleIndex = (self.nextSampleIndex + 1) % AchievementsFrameProfiler.windowSize
+        self.samplesSinceAdjustment += 1
+    }
+    
+    func percentiles() -> Percentiles?
+    {
+        guard !self.samples.isEmpty else { return nil }
+        
+        let durations = self.samples.map(\.duration).sorted()
+        
+        func percentile(_ percentile: Double) -> TimeInterval
+        {
+            let index = Int((Double(durations.count - 1) * percentile).rounded())
+            return durations[index]
+        }
+        
+        let totalPeeks = self.samples.reduce(0) { $0 + $1.memoryStatistics.peeks }
+        let totalBytesRead = self.samples.reduce(0) { $0 + $1.memoryStatistics.bytesRead }
+        
+        let percentiles = Percentiles(p50: percentile(0.5), p95: percentile(0.95), p99: percentile(0.99),
+                                      averagePeeks: Double(totalPeeks) / Double(self.samples.count),
+                                      averageBytesRead: Double(totalBytesRead) / Double(self.samples.count))
+        return percentiles
+    }
+    
+    // Returns true if frameInterval changed.
+    mutating func updateFrameInterval(frameDuration: TimeInterval, allowsSkippingFrames: Bool) -> Bool
+    {
+        let previousFrameInterval = self.frameInterval
+        
+        if !allowsSkippingFrames
+        {
+            self.frameInterval = 1
+        }
+        else
+        {
+            // Wait for a full second of new samples before re-evaluating.
+            guard self.samplesSinceAdjustment >= 60, let percentiles = self.percentiles() else { return false }
+            self.samplesSinceAdjustment = 0
+            
+            let budget = frameDuration * self.budgetFraction
+            
+            // Cost per frame is amortized across skipped frames.
+            if percentiles.p95 / Double(self.frameInterval) > budget
+            {
+                self.frameInterval = min(self.frameInterval * 2, AchievementsFrameProfiler.maximumFrameInterval)
+            }
+            else if self.frameInterval > 1 && percentiles.p95 / Double(self.frameInterval / 2) < budget / 2
+            {
+                // Would still be comfortably within budget, so gradually go back to evaluating every frame.
+                self.frameInterval /= 2
+            }
+        }
+        
+        return self.frameInterval != previousFrameInterval
+    }
+}
@@ -79,6 +79,7 @@ final class AchievementsManager
     private(set) var account: Account?
     
     private let session: URLSession
+    private let requestQueue: AchievementsRequestQueue
     private let authClient: OpaquePointer
 
     private init()
@@ -97,6 +98,10 @@ final class AchievementsManager
         configuration.httpAdditionalHeaders = ["User-Agent": userAgent]
         self.session = URLSession(configuration: .default)
         
+        let directoryURL = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0].appendingPathComponent("RetroAchievements", isDirectory: true)
+        self.requestQueue = AchievementsRequestQueue(directoryURL: directoryURL, session: self.session) { Keychain.shared.retroAchievementsAuthToken }
+        self.requestQueue.retryPendingRequests() // Send any unlocks that failed to send last launch.
+        
         self.authClient = rc_client_create({ address, buffer, numberOfBytes, client in
             // No need to read memory for authentication.
             return 0
@@ -169,6 +174,9 @@ extension AchievementsManager
             let account = Account(username: username, displayName: displayName, totalPoints: Int(info.pointee.score), avatarURL: avatarURL)
             AchievementsManager.shared.account = account
             
+            // Pending requests aren't retried while logged out, so send them now that we have a token.
+            AchievementsManager.shared.requestQueue.retryPendingRequests()
+            
             userData?.continuation?.resume()
             NotificationCenter.default.post(name: AchievementsManager.didFinishAuthenticatingNotification, object: nil, userInfo: [AchievementsManager.resultUserInfoKey: Result<Account, AchievementsError>.success(account)])
         }
@@ -222,15 +230,8 @@ extension AchievementsManager
             return
         }
         
-        var request = URLRequest(url: requestURL)
-        if let postBody = rawRequest.post_data
-        {
-            let body = String(cString: postBody)
-            request.httpBody = body.data(using: .utf8)
-            
-            // If postBody != nil, send POST request.
-            request.httpMethod = "POST"
-        }
+        let body = rawRequest.post_data.map { Data(String(cString: $0).utf8) }
+        let request = AchievementsRequestQueue.Request(url: requestURL, body: body)
         
         Task<Void, Never> {
             var serverResponse = rc_api_server_response_t()
@@ -238,11 +239,11 @@ extension AchievementsManager
             
             do
             {
-                let (data, response) = try await AchievementsManager.shared.session.data(for: request)
-                guard let httpResponse = response as? HTTPURLResponse else { throw URLError(.badServerResponse) }
+                // Handles caching, coalescing, and retrying requests while offline.
+                let response = try await AchievementsManager.shared.requestQueue.send(request)
                 
-                serverResponse.http_status_code = Int32(httpResponse.statusCode)
-                bodyData = data
+                serverResponse.http_status_code = Int32(response.statusCode)
+                bodyData = response.data
             }
             catch
             {
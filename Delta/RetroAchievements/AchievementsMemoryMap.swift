@@ -0,0 +1,147 @@
+//
+//  AchievementsMemoryMap.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+
+import DeltaCore
+
+// Contiguous block of console memory (e.g. a RAM bank), addressed the same way as EmulatorBridging.readMemory(at:size:).
+@objc(DLTAAchievementsMemoryRegion)
+final class AchievementsMemoryRegion: NSObject
+{
+    @objc let address: Int
+    @objc let size: Int
+    
+    // Must remain valid for as long as the emulator core is running the current game.
+    @objc let baseAddress: UnsafeMutableRawPointer
+    
+    @objc init(address: Int, size: Int, baseAddress: UnsafeMutableRawPointer)
+    {
+        self.address = address
+        self.size = size
+        self.baseAddress = baseAddress
+    }
+}
+
+// Adopted by emulator bridges that can expose stable pointers to console memory,
+// which lets RetroAchievements read memory directly instead of copying it via readMemory(at:size:).
+@objc(DLTAAchievementsMemoryMapping)
+protocol AchievementsMemoryMapping: NSObjectProtocol
+{
+    var achievementsMemoryRegions: [AchievementsMemoryRegion] { get }
+}
+
+struct AchievementsMemoryMap
+{
+    // Copied from AchievementsMemoryRegion so lookups don't go through Objective-C.
+    private struct Region
+    {
+        var address: Int
+        var size: Int
+        var baseAddress: UnsafeMutableRawPointer
+    }
+    
+    // Sorted by address.
+    private let regions: [Region]
+    
+    init?(emulatorBridge: EmulatorBridging)
+    {
+        guard let mapping = emulatorBridge as? AchievementsMemoryMapping else { return nil }
+        self.init(regions: mapping.achievementsMemoryRegions)
+    }
+    
+    init?(regions: [AchievementsMemoryRegion])
+    {
+        let regions = regions.lazy.filter { $0.size > 0 }.map { Region(address: $0.address, size: $0.size, baseAddress: $0.baseAddress) }.sorted { $0.address < $1.address }
+        guard !regions.isEmpty else { return nil }
+        
+        self.regions = regions
+    }
+    
+    // Returns nil if range isn't entirely contained within a single region.
+    func pointer(to address: Int, size: Int) -> UnsafeRawPointer?
+    {
+        // Binary search for last region starting at or before address.
+        var lowerBound = 0
+        var upperBound = self.regions.count
+        
+        while lowerBound < upperBound
+        {
+            let index = (lowerBound + upperBound) / 2
+            
+            if self.regions[index].address <= address
+            {
+                lowerBound = index + 1
+            }
+            else
+            {
+                upperBound = index
+            }
+        }
+        
+        guard lowerBound > 0 else { return nil }
+        
+        let region = self.regions[lowerBound - 1]
+        
+        let offset = address - region.address
+        guard size >= 0, offset + size <= region.size else { return nil }
+        
+        return UnsafeRawPointer(region.baseAddress + offset)
+    }
+}
+
+// Default path for emulator bridges that don't adopt AchievementsMemoryMapping.
+// Copies memory a page at a time via readMemory(at:size:), so nearby peeks during the same frame share one copy
+// rather than each allocating their own Data. Must be cleared whenever emulated memory may have changed.
+struct AchievementsMemoryPageCache
+{
+    static let pageSize = 256
+    
+    private let readMemory: (_ address: Int, _ size: Int) -> Data?
+    
+    // Empty if page couldn't be read (e.g. it extends past end of memory), so we don't try again until cleared.
+    private var pages = [Int: Data]()
+    
+    init(readMemory: @escaping (_ address: Int, _ size: Int) -> Data?)
+    {
+        self.readMemory = readMemory
+    }
+    
+    mutating func removeAll()
+    {
+        self.pages.removeAll(keepingCapacity: true)
+    }
+    
+    // Returns nil if range spans multiple pages or its page couldn't be read, in which case caller should read range directly.
+    mutating func read(at address: Int, into buffer: UnsafeMutablePointer<UInt8>, size: Int) -> Int?
+    {
+        let pageAddress = address - address % AchievementsMemoryPageCache.pageSize
+        
+        let offset = address - pageAddress
+        guard address >= 0, size >= 0, offset + size <= AchievementsMemoryPageCache.pageSize else { return nil }
+        
+        let page: Data
+        if let cachedPage = self.pages[pageAddress]
+        {
+            page = cachedPage
+        }
+        else
+        {
+            page = autoreleasepool { self.readMemory(pageAddress, AchievementsMemoryPageCache.pageSize) } ?? Data()
+            self.pages[pageAddress] = page
+        }
+        
+        guard offset + size <= page.count else { return nil }
+        
+        page.withUnsafeBytes { bytes in
+            _ = memcpy(buffer, bytes.baseAddress! + offset, size)
+        }
+        
+        return size
+    }
+}
@@ -0,0 +1,466 @@
+//
+//  AchievementsRequestQueue.swift
+//  Delta
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+
+// Sends RetroAchievements API requests, with support for being offline:
+// - Achievement unlocks + leaderboard submissions are persisted until the server receives them, and are retried with backoff (even after relaunching).
+//   Once persisted, the queue owns retrying them, so rc_client is told they succeeded to prevent it from submitting duplicates.
+// - Game + patch data responses are cached so reloading a game doesn't need to fetch them again. Expired responses are pruned on launch.
+// - Redundant rich presence pings are coalesced, so only the latest one is sent.
+final class AchievementsRequestQueue
+{
+    struct Request: Codable, Hashable
+    {
+        var url: URL
+        var body: Data?
+        
+        // Value of "r" parameter, e.g. "awardachievement".
+        var function: String? {
+            return self.parameters["r"]
+        }
+        
+        var parameters: [String: String] {
+            let parameters = (self.components.queryItems ?? []).reduce(into: [:]) { $0[$1.name] = $1.value ?? "" }
+            return parameters
+        }
+        
+        private var components: URLComponents {
+            var components = URLComponents()
+            components.percentEncodedQuery = self.body.flatMap { String(data: $0, encoding: .utf8) }
+            return components
+        }
+        
+        func replacingParameter(_ name: String, with value: String?) -> Request
+        {
+            guard let body = self.body else { return self }
+            
+            var components = self.components
+            var queryItems = (components.percentEncodedQueryItems ?? []).filter { $0.name != name }
+            
+            if let value, let encodedValue = value.addingPercentEncoding(withAllowedCharacters: .urlQueryAllowed.subtracting(CharacterSet(charactersIn: "&=+")))
+            {
+                queryItems.append(URLQueryItem(name: name, value: encodedValue))
+            }
+            
+            components.percentEncodedQueryItems = queryItems
+            
+            var request = self
+            request.body = components.percentEncodedQuery.map { Data($0.utf8) } ?? body
+            return request
+        }
+    }
+    
+    struct Response
+    {
+        var statusCode: Int
+        var data: Data
+    }
+    
+    let directoryURL: URL
+    
+    // Cached responses are used for up to a day, or up to a week if we're offline.
+    var cacheLifetime: TimeInterval = 24 * 60 * 60
+    var maximumCacheAge: TimeInterval = 7 * 24 * 60 * 60
+    
+    var cacheHitCount: Int {
+        return self.lock.withLock { self._cacheHitCount }
+    }
+    private var _cacheHitCount = 0
+    
+    var cacheMissCount: Int {
+        return self.lock.withLock { self._cacheMissCount }
+    }
+    private var _cacheMissCount = 0
+    
+    private let session: URLSession
+    private let authTokenProvider: () -> String?
+    
+    private var pendingRequests: [Request]
+    private var inFlightRequests = Set<Request>()
+    private var pingTasks = [String: Task<Response, Error>]()
+    
+    private var retryTask: Task<Void, Never>?
+    private var retryAttempt = 0
+    
+    private let lock = NSLock()
+    
+    private var pendingRequestsURL: URL {
+        return self.directoryURL.appendingPathComponent("PendingRequests.json")
+    }
+    
+    private var cacheDirectoryURL: URL {
+        return self.directoryURL.appendingPathComponent("Cache", isDirectory: true)
+    }
+    
+    // Auth tokens aren't persisted to disk, so authTokenProvider provides current token when retrying pending requests.
+    init(directoryURL: URL, session: URLSession, authTokenProvider: @escaping () -> String?)
+    {
+        self.directoryURL = directoryURL
+        self.session = session
+        self.authTokenProvider = authTokenProvider
+        
+        do
+        {
+            let data = try Data(contentsOf: directoryURL.appendingPathComponent("PendingRequests.json"))
+            self.pendingRequests = try JSONDecoder().decode([Request].self, from: data)
+        }
+        catch CocoaError.fileReadNoSuchFile
+        {
+            self.pendingRequests = []
+        }
+        catch
+        {
+            Logger.achievements.error("Failed to load pending RetroAchievements requests. \(error.localizedDescription, privacy: .public)")
+            self.pendingRequests = []
+        }
+        
+        do
+        {
+            try FileManager.default.createDirectory(at: self.cacheDirectoryURL, withIntermediateDirectories: true)
+        }
+        catch
+        {
+            Logger.achievements.error("Failed to create RetroAchievements cache directory. \(error.localizedDescription, privacy: .public)")
+        }
+        
+        DispatchQueue.global(qos: .utility).async {
+            self.removeExpiredCachedResponses()
+        }
+    }
+}
+
+extension AchievementsRequestQueue
+{
+    func send(_ request: Request) async throws -> Response
+    {
+        let response: Response
+        
+        switch request.function
+        {
+        case "gameid", "patch", "achievementsets":
+            response = try await self.sendCacheableRequest(request)
+            
+        case "ping":
+            response = try await self.sendPing(request)
+            
+        case "awardachievement", "submitlbentry":
+            response = try await self.sendPersistentRequest(request)
+            
+        default:
+            response = try await self.perform(request)
+        }
+        
+        if !(500...599).contains(response.statusCode)
+        {
+            // Reached server, so we're (probably) back online.
+            self.retryPendingRequests()
+        }
+        
+        return response
+    }
+    
+    // Sends any requests that failed to send previously.
+    func retryPendingRequests()
+    {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        
+        guard !self.pendingRequests.isEmpty, self.retryTask == nil else { return }
+        
+        self.retryTask = Task<Void, Never> {
+            await self.flushPendingRequests()
+        }
+    }
+    
+    // Pending requests remain persisted, and are sent next time retryPendingRequests() is called.
+    func cancelRetry()
+    {
+        self.lock.withLock {
+            self.retryTask?.cancel()
+            self.retryTask = nil
+            self.retryAttempt = 0
+        }
+    }
+}
+
+private extension AchievementsRequestQueue
+{
+    func perform(_ request: Request) async throws -> Response
+    {
+        var urlRequest = URLRequest(url: request.url)
+        
+        if let body = request.body
+        {
+            urlRequest.httpBody = body
+            
+            // If body != nil, send POST request.
+            urlRequest.httpMethod = "POST"
+        }
+        
+        let (data, response) = try await self.session.data(for: urlRequest)
+        guard let httpResponse = response as? HTTPURLResponse else { throw URLError(.badServerResponse) }
+        
+        return Response(statusCode: httpResponse.statusCode, data: data)
+    }
+    
+    func sendCacheableRequest(_ request: Request) async throws -> Response
+    {
+        let cacheURL = self.cacheURL(for: request)
+        
+        let cachedData = try? Data(contentsOf: cacheURL)
+        let cacheAge = (try? cacheURL.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate).map { -$0.timeIntervalSinceNow }
+        
+        if let cachedData, let cacheAge, cacheAge < self.cacheLifetime
+        {
+            self.lock.withLock { self._cacheHitCount += 1 }
+            return Response(statusCode: 200, data: cachedData)
+        }
+        
+        self.lock.withLock { self._cacheMissCount += 1 }
+        
+        do
+        {
+            let response = try await self.perform(request)
+            
+            if response.statusCode == 200
+            {
+                do
+                {
+                    try response.data.write(to: cacheURL, options: .atomic)
+                }
+                catch
+                {
+                    Logger.achievements.error("Failed to cache RetroAchievements response. \(error.localizedDescription, privacy: .public)")
+                }
+            }
+            
+            return response
+        }
+        catch let error as URLError
+        {
+            // Fall back to stale cached response when offline.
+            guard let cachedData, let cacheAge, cacheAge < self.maximumCacheAge else { throw error }
+            return Response(statusCode: 200, data: cachedData)
+        }
+    }
+    
+    func sendPing(_ request: Request) async throws -> Response
+    {
+        // Coalesce pings per game, since only the most recent one matters.
+        let key = request.parameters["g"] ?? ""
+        
+        let task = Task<Response, Error> {
+            try await self.perform(request)
+        }
+        
+        self.lock.withLock {
+            self.pingTasks[key]?.cancel()
+            self.pingTasks[key] = task
+        }
+        
+        do
+        {
+            let response = try await task.value
+            
+            self.lock.withLock {
+                if self.pingTasks[key] == task
+                {
+                    self.pingTasks[key] = nil
+                }
+            }
+            
+            return response
+        }
+        catch
+        {
+            let isSuperseded = self.lock.withLock {
+                guard self.pingTasks[key] == task else { return true }
+                
+                self.pingTasks[key] = nil
+                return false
+            }
+            
+            // Cancelled by a newer ping, so report success rather than having rc_client retry an outdated one.
+            guard isSuperseded else { throw error }
+            return Response(statusCode: 200, data: Data(#"{"Success":true}"#.utf8))
+        }
+    }
+    
+    func sendPersistentRequest(_ request: Request) async throws -> Response
+    {
+        let pendingRequest = request.replacingParameter("t", with: nil)
+        
+        // Persist before sending so it's not lost if app is terminated while sending.
+        self.lock.withLock {
+            self.inFlightRequests.insert(pendingRequest)
+            
+            guard !self.pendingRequests.contains(pendingRequest) else { return }
+            
+            self.pendingRequests.append(pendingRequest)
+            self.savePendingRequests()
+        }
+        
+        do
+        {
+            let response = try await self.perform(request)
+            guard !(500...599).contains(response.statusCode) else { throw URLError(.badServerResponse) }
+            
+            self.lock.withLock { _ = self.inFlightRequests.remove(pendingRequest) }
+            
+            // Server received request (even if it rejected it), so no need to retry.
+            self.removePendingRequest(pendingRequest)
+            
+            return response
+        }
+        catch
+        {
+            Logger.achievements.error("Failed to send RetroAchievements request, will retry later. \(error.localizedDescription, privacy: .public)")
+            
+            self.lock.withLock { _ = self.inFlightRequests.remove(pendingRequest) }
+            self.retryPendingRequests()
+            
+            // Request is persisted and we'll keep retrying it ourselves, so don't let rc_client retry it too (which could submit it twice).
+            let response = Response(statusCode: 200, data: self.queuedResponseData(for: request))
+            return response
+        }
+    }
+    
+    // Minimal successful response for a queued request, containing only the fields rcheevos requires to parse it.
+    func queuedResponseData(for request: Request) -> Data
+    {
+        let parameters = request.parameters
+        
+        let json: String
+        switch request.function
+        {
+        case "awardachievement":
+            let achievementID = Int(parameters["a"] ?? "") ?? 0
+            json = #"{"Success":true,"AchievementID":\#(achievementID)}"#
+            
+        case "submitlbentry":
+            let score = Int(parameters["s"] ?? "") ?? 0
+            json = #"{"Success":true,"Response":{"Score":\#(score),"BestScore":\#(score),"RankInfo":{"Rank":0,"NumEntries":0},"TopEntries":[]}}"#
+            
+        default:
+            json = #"{"Success":true}"#
+        }
+        
+        return Data(json.utf8)
+    }
+    
+    func flushPendingRequests() async
+    {
+        while !Task.isCancelled
+        {
+            // Skip requests currently being sent by rc_client.
+            let requests = self.lock.withLock { self.pendingRequests.filter { !self.inFlightRequests.contains($0) } }
+            guard !requests.isEmpty else { break }
+            
+            // Retrying won't help until user logs in again, at which point AchievementsManager calls retryPendingRequests().
+            guard let authToken = self.authTokenProvider() else {
+                Logger.achievements.info("Not sending pending RetroAchievements requests until user logs in.")
+                break
+            }
+            
+            do
+            {
+                for request in requests
+                {
+                    guard !Task.isCancelled else { break }
+                    
+                    let response = try await self.perform(request.replacingParameter("t", with: authToken))
+                    guard !(500...599).contains(response.statusCode) else { throw URLError(.badServerResponse) }
+                    
+                    self.removePendingRequest(request)
+                }
+                
+                self.lock.withLock { self.retryAttempt = 0 }
+            }
+            catch
+            {
+                Logger.achievements.error("Failed to send pending RetroAchievements request. \(error.localizedDescription, privacy: .public)")
+                
+                // Exponential backoff, up to 5 minutes.
+                let delay = self.lock.withLock {
+                    self.retryAttempt += 1
+                    return min(pow(2.0, Double(self.retryAttempt)), 5 * 60)
+                }
+                
+                try? await Task.sleep(nanoseconds: UInt64(delay * Double(NSEC_PER_SEC)))
+            }
+        }
+        
+        guard !Task.isCancelled else { return } // Cancelled tasks have already been replaced by cancelRetry().
+        
+        self.lock.withLock {
+            self.retryTask = nil
+            self.retryAttempt = 0
+        }
+    }
+    
+    func removePendingRequest(_ request: Request)
+    {
+        self.lock.withLock {
+            guard let index = self.pendingRequests.firstIndex(of: request) else { return }
+            
+            self.pendingRequests.remove(at: index)
+            self.savePendingRequests()
+        }
+    }
+    
+    // Must be called while holding lock.
+    func savePendingRequests()
+    {
+        do
+        {
+            let data = try JSONEncoder().encode(self.pendingRequests)
+            try data.write(to: self.pendingRequestsURL, options: .atomic)
+        }
+        catch
+        {
+            Logger.achievements.error("Failed to save pending RetroAchievements requests. \(error.localizedDescription, privacy: .public)")
+        }
+    }
+    
+    func removeExpiredCachedResponses()
+    {
+        do
+        {
+            let cacheURLs = try FileManager.default.contentsOfDirectory(at: self.cacheDirectoryURL, includingPropertiesForKeys: [.contentModificationDateKey], options: .skipsHiddenFiles)
+            
+            for cacheURL in cacheURLs
+            {
+                // Responses older than maximumCacheAge are never used, even when offline.
+                guard let modificationDate = try? cacheURL.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate,
+                      -modificationDate.timeIntervalSinceNow > self.maximumCacheAge
+                else { continue }
+                
+                try? FileManager.default.removeItem(at: cacheURL)
+            }
+        }
+        catch
+        {
+            Logger.achievements.error("Failed to prune RetroAchievements cache. \(error.localizedDescription, privacy: .public)")
+        }
+    }
+    
+    func cacheURL(for request: Request) -> URL
+    {
+        // Responses don't depend on user's token, so ignore it when caching.
+        var parameters = request.parameters
+        parameters["t"] = nil
+        
+        let key = request.url.absoluteString + "?" + parameters.sorted { $0.key < $1.key }.map { "\($0.key)=\($0.value)" }.joined(separator: "&")
+        let hash = SHA256.hash(data: Data(key.utf8)).map { String(format: "%02x", $0) }.joined()
+        
+        let cacheURL = self.cacheDirectoryURL.appendingPathComponent(hash).appendingPathExtension("json")
+        return cacheURL
+    }
+}
@@ -16,6 +16,14 @@ extension AchievementsTracker
     static let didUnlockAchievementNotification = Notification.Name("DLTADidUnlockAchievementNotification")
     
     static let achievementUserInfoKey: String = "achievement"
+    
+    struct MemoryStatistics
+    {
+        var peeks = 0
+        var directPeeks = 0 // Read directly from AchievementsMemoryMap, rather than copied via readMemory(at:size:).
+        var cachedPeeks = 0 // Read from a page already copied this frame by AchievementsMemoryPageCache.
+        var bytesRead = 0
+    }
 }
 
 final class AchievementsTracker
@@ -23,14 +31,44 @@ final class AchievementsTracker
     let emulatorCore: EmulatorCore
     private let gameURL: URL
     
+    // Memory statistics for the most recently processed frame.
+    private(set) var frameMemoryStatistics = MemoryStatistics()
+    
+    // Rolling processing time + memory statistics for recently processed frames.
+    var framePercentiles: AchievementsFrameProfiler.Percentiles? {
+        return self.frameProfiler.percentiles()
+    }
+    
+    // Achievements are evaluated every frameInterval frames, which increases if processing exceeds frame budget.
+    var frameInterval: Int {
+        return self.frameProfiler.frameInterval
+    }
+    
     private let client: OpaquePointer
     private let userData: UnsafeMutablePointer<AchievementsManager.UserData>
     
+    // nil if emulator core doesn't support AchievementsMemoryMapping, in which case we fall back to memoryPageCache.
+    private var memoryMap: AchievementsMemoryMap?
+    
+    // Only valid while evaluating a frame, since emulated memory doesn't change during rc_client_do_frame().
+    private var memoryPageCache: AchievementsMemoryPageCache
+    private var isEvaluatingFrame = false
+    
+    private var memoryStatistics = MemoryStatistics()
+    
+    private var frameProfiler = AchievementsFrameProfiler()
+    private var framesUntilEvaluation = 0
+    
     internal init(emulatorCore: EmulatorCore, authenticatedClient: OpaquePointer) throws
     {
         self.emulatorCore = emulatorCore
         self.gameURL = emulatorCore.game.fileURL // Copy fileURL so we can reference from any thread.
         
+        let emulatorBridge = emulatorCore.deltaCore.emulatorBridge
+        self.memoryPageCache = AchievementsMemoryPageCache { address, size in
+            emulatorBridge.readMemory?(at: address, size: size)
+        }
+        
         guard let authUserInfo = rc_client_get_user_info(authenticatedClient) else {
             throw AchievementsError(errorCode: AchievementsError.notAuthenticated, message: NSLocalizedString("User is not logged in.", comment: ""))
         }
@@ -89,6 +127,9 @@ extension AchievementsTracker
             self.emulatorCore.pause()
         }
         
+        // Memory regions are only valid once emulator core has started.
+        self.memoryMap = AchievementsMemoryMap(emulatorBridge: self.emulatorCore.deltaCore.emulatorBridge)
+        
         let consoleType = switch System(gameType: self.emulatorCore.deltaCore.gameType) {
         case .nes: RC_CONSOLE_NINTENDO
         case .snes: RC_CONSOLE_SUPER_NINTENDO
@@ -177,13 +218,36 @@ internal extension AchievementsTracker
 
     func readBytes(at address: Int, into buffer: UnsafeMutablePointer<UInt8>, size: Int) -> Int
     {
-        autoreleasepool {
+        self.memoryStatistics.peeks += 1
+        
+        if let pointer = self.memoryMap?.pointer(to: address, size: size)
+        {
+            // No allocations or Objective-C messaging, unlike readMemory(at:size:).
+            memcpy(buffer, pointer, size)
+            
+            self.memoryStatistics.directPeeks += 1
+            self.memoryStatistics.bytesRead += size
+            
+            return size
+        }
+        
+        if self.isEvaluatingFrame, let size = self.memoryPageCache.read(at: address, into: buffer, size: size)
+        {
+            self.memoryStatistics.cachedPeeks += 1
+            self.memoryStatistics.bytesRead += size
+            
+            return size
+        }
+        
+        return autoreleasepool {
             guard let data = self.emulatorCore.deltaCore.emulatorBridge.readMemory?(at: address, size: size) else { return 0 }
             
             data.withUnsafeBytes { bytes in
                 _ = memcpy(buffer, bytes.baseAddress, data.count)
             }
             
+            self.memoryStatistics.bytesRead += data.count
+            
             return data.count
         }
     }
@@ -193,6 +257,40 @@ private extension AchievementsTracker
 {
     func didRenderFrame()
     {
+        self.framesUntilEvaluation -= 1
+        
+        guard self.framesUntilEvaluation <= 0 else {
+            // Still process periodic tasks (e.g. rich presence pings) when skipping frames.
+            rc_client_idle(self.client)
+            return
+        }
+        
+        self.framesUntilEvaluation = self.frameProfiler.frameInterval
+        
+        self.memoryStatistics = MemoryStatistics()
+        
+        // Emulated memory changed since last frame, so discard previously copied pages.
+        self.memoryPageCache.removeAll()
+        self.isEvaluatingFrame = true
+        
+        let startTime = DispatchTime.now().uptimeNanoseconds
         rc_client_do_frame(self.client)
+        let duration = TimeInterval(DispatchTime.now().uptimeNanoseconds - startTime) / TimeInterval(NSEC_PER_SEC)
+        
+        self.isEvaluatingFrame = false
+        
+        self.frameMemoryStatistics = self.memoryStatistics
+        self.frameProfiler.record(.init(duration: duration, memoryStatistics: self.memoryStatistics))
+        
+        // Emulator core runs faster than real-time when fast forwarding, shrinking our budget.
+        let frameDuration = self.emulatorCore.deltaCore.emulatorBridge.frameDuration / max(self.emulatorCore.rate, 1.0)
+        
+        // Hardcore mode requires evaluating every frame, since skipping frames can affect hit counts.
+        let allowsSkippingFrames = (rc_client_get_hardcore_enabled(self.client) == 0)
+        
+        if self.frameProfiler.updateFrameInterval(frameDuration: frameDuration, allowsSkippingFrames: allowsSkippingFrames), let percentiles = self.frameProfiler.percentiles()
+        {
+            Logger.achievements.info("Evaluating achievements every \(self.frameProfiler.frameInterval) frame(s). p95: \(percentiles.p95 * 1000, format: .fixed(precision: 2))ms, average peeks: \(percentiles.averagePeeks, format: .fixed(precision: 1))")
+        }
     }
 }
@@ -31,7 +31,10 @@ class ControllerInputsViewController: UIViewController
     private lazy var managedObjectContext: NSManagedObjectContext = DatabaseManager.shared.newBackgroundContext()
     private var inputMappings = [System: GameControllerInputMapping]()
     
-    private let supportedActionInputs: [ActionInput] = [.quickSave, .quickLoad, .fastForward, .screenshot]
+    private var supportedActionInputs: [ActionInput] {
+        guard ExperimentalFeatures.shared.rewind.isEnabled, RewindController.isSupported(by: self.system) else { return [.quickSave, .quickLoad, .fastForward, .screenshot] }
+        return [.quickSave, .quickLoad, .fastForward, .screenshot, .rewind]
+    }
     
     private var gameViewController: DeltaCore.GameViewController!
     private var actionsMenuViewController: GridMenuViewController!
@@ -183,6 +186,10 @@ private extension ControllerInputsViewController
         self.gameViewController.controllerView.controllerSkin = DeltaCore.ControllerSkin.standardControllerSkin(for: self.system.gameType)
         self.gameViewController.view.setNeedsUpdateConstraints()
         
+        // Supported actions depend on system (e.g. Rewind).
+        self.prepareActionsMenuViewController()
+        self.view.setNeedsLayout()
+        
         // Fetch input mapping if it hasn't already been fetched.
         if let gameController = self.gameController, self.inputMappings[self.system] == nil
         {
@@ -262,6 +269,10 @@ private extension ControllerInputsViewController
                 image = #imageLiteral(resourceName: "Screenshot")
                 text = NSLocalizedString("Screenshot", comment: "")
                 
+            case .rewind:
+                image = UIImage(systemName: "backward.fill")!
+                text = NSLocalizedString("Rewind", comment: "")
+                
             case .toggleFastForward, .reverseScreens: continue
             }
             
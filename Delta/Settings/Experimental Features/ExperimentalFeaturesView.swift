@@ -20,8 +20,18 @@ extension ExperimentalFeaturesView
         
         init()
         {
+            // Hide features no registered core supports.
+            var unsupportedFeatureKeys = Set<String>()
+            
+            if !System.registeredSystems.contains(where: RewindController.isSupported(by:))
+            {
+                unsupportedFeatureKeys.insert(ExperimentalFeatures.shared.rewind.key)
+            }
+            
+            let features = ExperimentalFeatures.shared.allFeatures.filter { !unsupportedFeatureKeys.contains($0.key) }
+            
             // Sort features alphabetically by name.
-            self.sortedFeatures = ExperimentalFeatures.shared.allFeatures.sorted { (featureA, featureB) in
+            self.sortedFeatures = features.sorted { (featureA, featureB) in
                 return String(describing: featureA.name) < String(describing: featureB.name)
             }
         }
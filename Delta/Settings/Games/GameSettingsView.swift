@@ -68,6 +68,27 @@ struct GameSettingsView: View
                 }
             }
             
+            // Run-ahead requires saving + loading state every frame, which only some cores are fast enough for.
+            if let system, system.supportsRunAhead
+            {
+                Section {
+                    let binding = Binding {
+                        game.settings[.runAheadFrames] as? Int ?? 0
+                    } set: { frameCount in
+                        game.settings[.runAheadFrames] = (frameCount > 0) ? frameCount : nil
+                    }
+                    
+                    Stepper(value: binding, in: 0...RunAheadController.maximumFrameCount) {
+                        let frameCount = binding.wrappedValue
+                        Text(frameCount == 0 ? "Run-Ahead: Off" : "Run-Ahead: \(frameCount) Frame(s)")
+                    }
+                } header: {
+                    Text("Latency")
+                } footer: {
+                    Text("Reduce input lag by running this game ahead and displaying future frames. Most games need 1–2 frames; higher values may cause slowdown on older devices.")
+                }
+            }
+            
             if system == .ds
             {
                 Section {
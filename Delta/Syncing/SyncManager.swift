@@ -244,6 +244,23 @@ private extension SyncManager
         self.syncProgress = nil
         
         print("Finished syncing!")
+        
+        // Harmony replaces downloaded save states with new files, so link them back to their deduplicated blobs.
+        DatabaseManager.shared.performBackgroundTask { (context) in
+            let fetchRequest: NSFetchRequest<SaveState> = SaveState.fetchRequest()
+            fetchRequest.predicate = NSPredicate(format: "%K != nil", #keyPath(SaveState.game))
+            fetchRequest.relationshipKeyPathsForPrefetching = [#keyPath(SaveState.game)]
+            
+            do
+            {
+                let fileURLs = try context.fetch(fetchRequest).map { $0.fileURL }
+                DatabaseManager.shared.saveStateBlobStore.relinkItems(at: fileURLs)
+            }
+            catch
+            {
+                Logger.sync.error("Failed to fetch save states to relink. \(error.localizedDescription, privacy: .public)")
+            }
+        }
     }
     
     @objc func didEnterBackground(_ notification: Notification)
@@ -120,6 +120,15 @@ extension System
         }
     }
     
+    // Some cores (e.g. N64) return from saveSaveState(to:) before they've finished writing the save state.
+    var writesSaveStatesAsynchronously: Bool {
+        switch self
+        {
+        case .n64: return true
+        case .nes, .snes, .gbc, .gba, .ds, .genesis: return false
+        }
+    }
+    
     var gameType: DeltaCore.GameType {
         switch self
         {
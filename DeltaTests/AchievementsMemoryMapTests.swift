@@ -0,0 +1,142 @@
+//
+//  AchievementsMemoryMapTests.swift
+//  DeltaTests
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import XCTest
+
+@testable import Delta
+
+class AchievementsMemoryMapTests: XCTestCase
+{
+    private var memory: UnsafeMutableRawBufferPointer!
+    
+    override func setUp()
+    {
+        super.setUp()
+        
+        self.memory = UnsafeMutableRawBufferPointer.allocate(byteCount: 4096, alignment: 1)
+        for index in 0 ..< self.memory.count
+        {
+            self.memory[index] = UInt8(truncatingIfNeeded: index)
+        }
+    }
+    
+    override func tearDown()
+    {
+        self.memory.deallocate()
+        
+        super.tearDown()
+    }
+}
+
+//MARK: - Memory Map -
+extension AchievementsMemoryMapTests
+{
+    func testPointerWithinRegion() throws
+    {
+        // Regions deliberately out of order.
+        let memoryMap = try XCTUnwrap(AchievementsMemoryMap(regions: [
+            AchievementsMemoryRegion(address: 0x1000, size: 1024, baseAddress: self.memory.baseAddress! + 1024),
+            AchievementsMemoryRegion(address: 0x0000, size: 1024, baseAddress: self.memory.baseAddress!),
+        ]))
+        
+        XCTAssertEqual(memoryMap.pointer(to: 0x0000, size: 4), UnsafeRawPointer(self.memory.baseAddress!))
+        XCTAssertEqual(memoryMap.pointer(to: 0x03FC, size: 4), UnsafeRawPointer(self.memory.baseAddress! + 0x03FC))
+        XCTAssertEqual(memoryMap.pointer(to: 0x1010, size: 2), UnsafeRawPointer(self.memory.baseAddress! + 1024 + 0x10))
+    }
+    
+    func testPointerOutsideRegions() throws
+    {
+        let memoryMap = try XCTUnwrap(AchievementsMemoryMap(regions: [
+            AchievementsMemoryRegion(address: 0x0000, size: 1024, baseAddress: self.memory.baseAddress!),
+            AchievementsMemoryRegion(address: 0x0400, size: 1024, baseAddress: self.memory.baseAddress! + 2048),
+        ]))
+        
+        // Between regions, past last region, and spanning two (non-contiguous in memory) regions.
+        XCTAssertNil(memoryMap.pointer(to: 0x0800, size: 1))
+        XCTAssertNil(memoryMap.pointer(to: 0x10000, size: 1))
+        XCTAssertNil(memoryMap.pointer(to: 0x03FE, size: 4))
+    }
+    
+    func testEmptyRegionsAreIgnored()
+    {
+        XCTAssertNil(AchievementsMemoryMap(regions: []))
+        XCTAssertNil(AchievementsMemoryMap(regions: [AchievementsMemoryRegion(address: 0, size: 0, baseAddress: self.memory.baseAddress!)]))
+    }
+}
+
+//MARK: - Page Cache -
+extension AchievementsMemoryMapTests
+{
+    func testPageCacheReadsEachPageOnce() throws
+    {
+        var readCount = 0
+        var pageCache = self.makePageCache { readCount += 1 }
+        
+        var buffer = [UInt8](repeating: 0, count: 4)
+        
+        for address in [0x10, 0x14, 0x80, 0xFC]
+        {
+            XCTAssertEqual(pageCache.read(at: address, into: &buffer, size: 4), 4)
+            XCTAssertEqual(buffer, self.bytes(at: address, count: 4))
+        }
+        
+        XCTAssertEqual(readCount, 1)
+        
+        XCTAssertEqual(pageCache.read(at: 0x100, into: &buffer, size: 4), 4)
+        XCTAssertEqual(buffer, self.bytes(at: 0x100, count: 4))
+        XCTAssertEqual(readCount, 2)
+        
+        // Memory changed, so pages must be read again.
+        pageCache.removeAll()
+        
+        XCTAssertEqual(pageCache.read(at: 0x10, into: &buffer, size: 4), 4)
+        XCTAssertEqual(readCount, 3)
+    }
+    
+    func testPageCacheRejectsReadsSpanningPages()
+    {
+        var pageCache = self.makePageCache()
+        
+        var buffer = [UInt8](repeating: 0, count: 4)
+        XCTAssertNil(pageCache.read(at: AchievementsMemoryPageCache.pageSize - 2, into: &buffer, size: 4))
+    }
+    
+    func testPageCacheRejectsUnreadablePages()
+    {
+        var readCount = 0
+        var pageCache = self.makePageCache { readCount += 1 }
+        
+        // Past end of memory, so readMemory fails. Failure is cached too.
+        var buffer = [UInt8](repeating: 0, count: 4)
+        XCTAssertNil(pageCache.read(at: self.memory.count + 4, into: &buffer, size: 4))
+        XCTAssertNil(pageCache.read(at: self.memory.count + 8, into: &buffer, size: 4))
+        XCTAssertEqual(readCount, 1)
+    }
+}
+
+private extension AchievementsMemoryMapTests
+{
+    func makePageCache(didReadMemory: @escaping () -> Void = {}) -> AchievementsMemoryPageCache
+    {
+        let memory = self.memory!
+        
+        let pageCache = AchievementsMemoryPageCache { address, size in
+            didReadMemory()
+            
+            guard address >= 0, address + size <= memory.count else { return nil }
+            return Data(memory[address ..< address + size])
+        }
+        
+        return pageCache
+    }
+    
+    func bytes(at address: Int, count: Int) -> [UInt8]
+    {
+        return Array(self.memory[address ..< address + count])
+    }
+}
@@ -0,0 +1,305 @@
+//
+//  AchievementsRequestQueueTests.swift
+//  DeltaTests
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import XCTest
+
+@testable import Delta
+
+private typealias Request = AchievementsRequestQueue.Request
+
+class AchievementsRequestQueueTests: XCTestCase
+{
+    private static let serverURL = URL(string: "https://retroachievements.org/dorequest.php")!
+    
+    private var directoryURL: URL!
+    private var session: URLSession!
+    
+    // Cancelled during teardown so background retries don't outlive their test.
+    private var queues = [AchievementsRequestQueue]()
+    
+    override func setUpWithError() throws
+    {
+        try super.setUpWithError()
+        
+        self.directoryURL = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try FileManager.default.createDirectory(at: self.directoryURL, withIntermediateDirectories: true)
+        
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [StubURLProtocol.self]
+        self.session = URLSession(configuration: configuration)
+        
+        StubURLProtocol.reset()
+    }
+    
+    override func tearDownWithError() throws
+    {
+        self.queues.forEach { $0.cancelRetry() }
+        self.queues = []
+        
+        StubURLProtocol.reset()
+        
+        self.session.invalidateAndCancel()
+        try? FileManager.default.removeItem(at: self.directoryURL)
+        
+        try super.tearDownWithError()
+    }
+}
+
+//MARK: - Persistent Requests -
+extension AchievementsRequestQueueTests
+{
+    func testFailedUnlockIsQueuedWithoutToken() async throws
+    {
+        StubURLProtocol.setResponse(statusCode: 503)
+        
+        // No token, so queue doesn't retry in the background during this test.
+        let queue = self.makeQueue(authToken: nil)
+        
+        let response = try await queue.send(self.unlockRequest(achievementID: 42, token: "TOKEN"))
+        XCTAssertEqual(response.statusCode, 200)
+        
+        let json = try XCTUnwrap(try JSONSerialization.jsonObject(with: response.data) as? [String: Any])
+        XCTAssertEqual(json["Success"] as? Bool, true)
+        XCTAssertEqual(json["AchievementID"] as? Int, 42)
+        
+        let pendingRequests = try self.pendingRequests()
+        XCTAssertEqual(pendingRequests.count, 1)
+        XCTAssertEqual(pendingRequests.first?.function, "awardachievement")
+        XCTAssertEqual(pendingRequests.first?.parameters["a"], "42")
+        XCTAssertNil(pendingRequests.first?.parameters["t"])
+        
+        let pendingRequestsData = try Data(contentsOf: self.directoryURL.appendingPathComponent("PendingRequests.json"))
+        XCTAssertFalse(String(decoding: pendingRequestsData, as: UTF8.self).contains("TOKEN"))
+    }
+    
+    func testOfflineLeaderboardSubmissionIsQueued() async throws
+    {
+        StubURLProtocol.setError(URLError(.notConnectedToInternet))
+        
+        let queue = self.makeQueue(authToken: nil)
+        
+        let request = Request(url: AchievementsRequestQueueTests.serverURL, body: Data("r=submitlbentry&u=user&t=TOKEN&i=7&s=1234&m=0&v=0".utf8))
+        let response = try await queue.send(request)
+        XCTAssertEqual(response.statusCode, 200)
+        
+        // rcheevos requires Response.Score, BestScore, RankInfo and TopEntries to parse a successful submission.
+        let json = try XCTUnwrap(try JSONSerialization.jsonObject(with: response.data) as? [String: Any])
+        XCTAssertEqual(json["Success"] as? Bool, true)
+        
+        let submission = try XCTUnwrap(json["Response"] as? [String: Any])
+        XCTAssertEqual(submission["Score"] as? Int, 1234)
+        XCTAssertEqual(submission["BestScore"] as? Int, 1234)
+        XCTAssertNotNil(submission["RankInfo"] as? [String: Any])
+        XCTAssertNotNil(submission["TopEntries"] as? [Any])
+        
+        XCTAssertEqual(try self.pendingRequests().map(\.function), ["submitlbentry"])
+    }
+    
+    func testRejectedUnlockIsNotQueued() async throws
+    {
+        // Server received request but rejected it, so retrying won't help.
+        StubURLProtocol.setResponse(statusCode: 200, json: #"{"Success":false,"Error":"Unknown achievement"}"#)
+        
+        let queue = self.makeQueue(authToken: "TOKEN")
+        
+        let response = try await queue.send(self.unlockRequest(achievementID: 42, token: "TOKEN"))
+        XCTAssertEqual(String(decoding: response.data, as: UTF8.self), #"{"Success":false,"Error":"Unknown achievement"}"#)
+        
+        XCTAssertEqual(try self.pendingRequests(), [])
+    }
+    
+    func testPendingRequestsAreRetriedAfterRelaunch() async throws
+    {
+        StubURLProtocol.setResponse(statusCode: 503)
+        
+        let queue = self.makeQueue(authToken: nil)
+        _ = try await queue.send(self.unlockRequest(achievementID: 1, token: "OLD_TOKEN"))
+        _ = try await queue.send(self.unlockRequest(achievementID: 2, token: "OLD_TOKEN"))
+        
+        XCTAssertEqual(try self.pendingRequests().count, 2)
+        
+        // New queue loads pending requests from disk, and sends them with current token once server is reachable.
+        StubURLProtocol.setResponse(statusCode: 200, json: #"{"Success":true}"#)
+        StubURLProtocol.removeRecordedRequests()
+        
+        let relaunchedQueue = self.makeQueue(authToken: "NEW_TOKEN")
+        relaunchedQueue.retryPendingRequests()
+        
+        try await self.waitUntil { try self.pendingRequests().isEmpty }
+        
+        let sentRequests = StubURLProtocol.recordedRequests
+        XCTAssertEqual(sentRequests.map { $0.parameters["a"] }, ["1", "2"])
+        XCTAssertEqual(sentRequests.map { $0.parameters["t"] }, ["NEW_TOKEN", "NEW_TOKEN"])
+    }
+}
+
+//MARK: - Cached Requests -
+extension AchievementsRequestQueueTests
+{
+    func testCachedResponseIsUsedWhileOffline() async throws
+    {
+        let request = Request(url: AchievementsRequestQueueTests.serverURL, body: Data("r=patch&u=user&t=TOKEN&g=100".utf8))
+        
+        StubURLProtocol.setResponse(statusCode: 200, json: #"{"Success":true,"PatchData":{}}"#)
+        
+        let queue = self.makeQueue(authToken: "TOKEN")
+        _ = try await queue.send(request)
+        
+        _ = try await queue.send(request)
+        XCTAssertEqual(StubURLProtocol.recordedRequests.count, 1)
+        XCTAssertEqual(queue.cacheHitCount, 1)
+        XCTAssertEqual(queue.cacheMissCount, 1)
+        
+        // Expired, but still used if we can't reach server.
+        queue.cacheLifetime = 0
+        StubURLProtocol.setError(URLError(.notConnectedToInternet))
+        
+        let response = try await queue.send(request)
+        XCTAssertEqual(response.statusCode, 200)
+        XCTAssertEqual(String(decoding: response.data, as: UTF8.self), #"{"Success":true,"PatchData":{}}"#)
+    }
+}
+
+private extension AchievementsRequestQueueTests
+{
+    func makeQueue(authToken: String?) -> AchievementsRequestQueue
+    {
+        let queue = AchievementsRequestQueue(directoryURL: self.directoryURL, session: self.session) { authToken }
+        self.queues.append(queue)
+        return queue
+    }
+    
+    func unlockRequest(achievementID: Int, token: String) -> Request
+    {
+        let request = Request(url: AchievementsRequestQueueTests.serverURL, body: Data("r=awardachievement&u=user&t=\(token)&a=\(achievementID)&h=0".utf8))
+        return request
+    }
+    
+    func pendingRequests() throws -> [Request]
+    {
+        let data = try Data(contentsOf: self.directoryURL.appendingPathComponent("PendingRequests.json"))
+        
+        let requests = try JSONDecoder().decode([Request].self, from: data)
+        return requests
+    }
+    
+    func waitUntil(timeout: TimeInterval = 5.0, file: StaticString = #filePath, line: UInt = #line, _ condition: () throws -> Bool) async throws
+    {
+        let deadline = Date().addingTimeInterval(timeout)
+        
+        while try !condition()
+        {
+            guard Date() < deadline else {
+                XCTFail("Timed out waiting for condition.", file: file, line: line)
+                return
+            }
+            
+            try await Task.sleep(nanoseconds: 10 * NSEC_PER_MSEC)
+        }
+    }
+}
+
+// Responds to every request with the current stubbed response, and records requests it received.
+private class StubURLProtocol: URLProtocol
+{
+    private static var result: Result<(statusCode: Int, data: Data), Error> = .success((200, Data()))
+    private static var _recordedRequests = [Request]()
+    private static let lock = NSLock()
+    
+    static var recordedRequests: [Request] {
+        return self.lock.withLock { self._recordedRequests }
+    }
+    
+    static func setResponse(statusCode: Int, json: String = "")
+    {
+        self.lock.withLock { self.result = .success((statusCode, Data(json.utf8))) }
+    }
+    
+    static func setError(_ error: Error)
+    {
+        self.lock.withLock { self.result = .failure(error) }
+    }
+    
+    static func removeRecordedRequests()
+    {
+        self.lock.withLock { self._recordedRequests.removeAll() }
+    }
+    
+    static func reset()
+    {
+        self.lock.withLock {
+            self.result = .success((200, Data()))
+            self._recordedRequests.removeAll()
+        }
+    }
+    
+    override class func canInit(with request: URLRequest) -> Bool
+    {
+        return true
+    }
+    
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest
+    {
+        return request
+    }
+    
+    override func startLoading()
+    {
+        guard let url = self.request.url else { return }
+        
+        let request = Request(url: url, body: self.requestBody())
+        
+        let result = StubURLProtocol.lock.withLock {
+            StubURLProtocol._recordedRequests.append(request)
+            return StubURLProtocol.result
+        }
+        
+        switch result
+        {
+        case .success(let (statusCode, data)):
+            let response = HTTPURLResponse(url: url, statusCode: statusCode, httpVersion: "HTTP/1.1", headerFields: ["Content-Type": "application/json"])!
+            self.client?.urlProtocol(self, didReceive: response, cacheStoragePolicy: .notAllowed)
+            self.client?.urlProtocol(self, didLoad: data)
+            self.client?.urlProtocolDidFinishLoading(self)
+        
+        case .failure(let error):
+            self.client?.urlProtocol(self, didFailWithError: error)
+        }
+    }
+    
+    override func stopLoading()
+    {
+    }
+    
+    // URLSession converts httpBody into httpBodyStream before passing requests to URLProtocols.
+    private func requestBody() -> Data?
+    {
+        if let body = self.request.httpBody
+        {
+            return body
+        }
+        
+        guard let stream = self.request.httpBodyStream else { return nil }
+        
+        stream.open()
+        defer { stream.close() }
+        
+        var body = Data()
+        var buffer = [UInt8](repeating: 0, count: 4096)
+        
+        while stream.hasBytesAvailable
+        {
+            let count = stream.read(&buffer, maxLength: buffer.count)
+            guard count > 0 else { break }
+            
+            body.append(buffer, count: count)
+        }
+        
+        return body
+    }
+}
@@ -0,0 +1,188 @@
+//
+//  GamesDatabaseTests.swift
+//  DeltaTests
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import XCTest
+import SQLite
+
+@testable import Delta
+
+class GamesDatabaseTests: XCTestCase
+{
+    // Enough to benchmark 10k lookups, which span many GamesDatabase.maximumBatchSize batches.
+    private static let romCount = 10_000
+    
+    private var databaseURL: URL!
+    private var gamesDatabase: GamesDatabase!
+    
+    override func setUpWithError() throws
+    {
+        try super.setUpWithError()
+        
+        self.databaseURL = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString).appendingPathExtension("sqlite")
+        try GamesDatabaseTests.makeDatabase(at: self.databaseURL, romCount: GamesDatabaseTests.romCount)
+        
+        self.gamesDatabase = try GamesDatabase(fileURL: self.databaseURL)
+    }
+    
+    override func tearDownWithError() throws
+    {
+        self.gamesDatabase = nil
+        try? FileManager.default.removeItem(at: self.databaseURL)
+        
+        try super.tearDownWithError()
+    }
+}
+
+extension GamesDatabaseTests
+{
+    func testMetadataForHashesSpanningMultipleBatches() throws
+    {
+        // Callers may use lowercase hashes, but OpenVGDB stores them uppercase.
+        let hashes = (0 ..< GamesDatabaseTests.romCount).map { GamesDatabaseTests.sha1Hash(forROMID: $0).lowercased() }
+        
+        let metadata = self.gamesDatabase.metadata(forSHA1Hashes: hashes)
+        XCTAssertEqual(metadata.count, hashes.count)
+        
+        for (romID, hash) in hashes.enumerated()
+        {
+            let metadata = try XCTUnwrap(metadata[hash], "Missing metadata for ROM \(romID)")
+            XCTAssertEqual(metadata.romID, romID)
+            XCTAssertEqual(metadata.releaseID, romID + 10_000)
+            XCTAssertEqual(metadata.name, "Game \(romID)")
+            XCTAssertEqual(metadata.artworkURL, URL(string: "https://example.com/\(romID).png"))
+        }
+    }
+    
+    func testMetadataOmitsUnknownHashes() throws
+    {
+        let knownHashes = [0, 499, 500, 1000].map { GamesDatabaseTests.sha1Hash(forROMID: $0) }
+        let unknownHashes = (0 ..< 600).map { GamesDatabaseTests.sha1Hash(forROMID: GamesDatabaseTests.romCount + $0) }
+        
+        let metadata = self.gamesDatabase.metadata(forSHA1Hashes: unknownHashes + knownHashes)
+        XCTAssertEqual(Set(metadata.keys), Set(knownHashes))
+    }
+    
+    func testMetadataForNoHashes()
+    {
+        let metadata = self.gamesDatabase.metadata(forSHA1Hashes: [])
+        XCTAssertTrue(metadata.isEmpty)
+    }
+    
+    func testMetadataWithoutArtwork() throws
+    {
+        let connection = try Connection(self.databaseURL.path)
+        try connection.run("UPDATE RELEASES SET releaseCoverFront = NULL WHERE romID = 7")
+        
+        let hash = GamesDatabaseTests.sha1Hash(forROMID: 7)
+        let metadata = try XCTUnwrap(self.gamesDatabase.metadata(forSHA1Hashes: [hash])[hash])
+        XCTAssertEqual(metadata.name, "Game 7")
+        XCTAssertNil(metadata.artworkURL)
+    }
+}
+
+//MARK: - Benchmarks -
+// Compares one query per hash (as metadata(for:) used to do) with batched IN (...) queries.
+extension GamesDatabaseTests
+{
+    func testPerRowLookupPerformance1K() throws
+    {
+        try self.measurePerRowLookups(count: 1_000)
+    }
+    
+    func testBatchedLookupPerformance1K()
+    {
+        self.measureBatchedLookups(count: 1_000)
+    }
+    
+    func testPerRowLookupPerformance10K() throws
+    {
+        try self.measurePerRowLookups(count: 10_000)
+    }
+    
+    func testBatchedLookupPerformance10K()
+    {
+        self.measureBatchedLookups(count: 10_000)
+    }
+}
+
+private extension GamesDatabaseTests
+{
+    static func sha1Hash(forROMID romID: Int) -> String
+    {
+        return String(format: "%040X", romID)
+    }
+    
+    // Hashes spread across entire database, so lookups aren't just reading neighboring rows.
+    static func lookupHashes(count: Int) -> [String]
+    {
+        let stride = GamesDatabaseTests.romCount / count
+        
+        let hashes = (0 ..< count).map { GamesDatabaseTests.sha1Hash(forROMID: $0 * stride).lowercased() }
+        return hashes
+    }
+    
+    func measurePerRowLookups(count: Int) throws
+    {
+        let releaseID = SQLite.Expression<Any>.releaseID
+        let name = SQLite.Expression<Any>.name
+        let artworkAddress = SQLite.Expression<Any>.artworkAddress
+        let sha1Hash = SQLite.Expression<Any>.sha1Hash
+        let romID = SQLite.Expression<Any>.romID
+        
+        // Same indexes GamesDatabase built when it was initialized.
+        let connection = try Connection(self.databaseURL.path, readonly: true)
+        let hashes = GamesDatabaseTests.lookupHashes(count: count)
+        
+        self.measure {
+            var metadataByHash = [String: GameMetadata]()
+            
+            for hash in hashes
+            {
+                let query = Table.roms.select(releaseID, name, artworkAddress, Table.roms[romID]).filter(sha1Hash == hash.uppercased()).join(Table.releases, on: Table.roms[romID] == Table.releases[romID])
+                
+                guard let row = try? connection.pluck(query) else { continue }
+                metadataByHash[hash] = GameMetadata(releaseID: row[releaseID], romID: row[Table.roms[romID]], name: row[name], artworkURL: row[artworkAddress].flatMap { URL(string: $0) })
+            }
+            
+            XCTAssertEqual(metadataByHash.count, count)
+        }
+    }
+    
+    func measureBatchedLookups(count: Int)
+    {
+        let hashes = GamesDatabaseTests.lookupHashes(count: count)
+        
+        // Open reader connection + prepare statements before measuring, as they would be after first lookup.
+        _ = self.gamesDatabase.metadata(forSHA1Hashes: hashes)
+        
+        self.measure {
+            let metadataByHash = self.gamesDatabase.metadata(forSHA1Hashes: hashes)
+            XCTAssertEqual(metadataByHash.count, count)
+        }
+    }
+    
+    // Minimal subset of the OpenVGDB schema used by metadata(forSHA1Hashes:).
+    static func makeDatabase(at fileURL: URL, romCount: Int) throws
+    {
+        let connection = try Connection(fileURL.path)
+        
+        try connection.execute("""
+            CREATE TABLE ROMs (romID INTEGER PRIMARY KEY, romHashSHA1 TEXT);
+            CREATE TABLE RELEASES (releaseID INTEGER PRIMARY KEY, romID INTEGER, releaseTitleName TEXT, releaseCoverFront TEXT);
+            """)
+        
+        try connection.transaction {
+            for romID in 0 ..< romCount
+            {
+                try connection.run("INSERT INTO ROMs (romID, romHashSHA1) VALUES (?, ?)", romID, GamesDatabaseTests.sha1Hash(forROMID: romID))
+                try connection.run("INSERT INTO RELEASES (releaseID, romID, releaseTitleName, releaseCoverFront) VALUES (?, ?, ?, ?)",
+                                   romID + 10_000, romID, "Game \(romID)", "https://example.com/\(romID).png")
+            }
+        }
+    }
+}
@@ -0,0 +1,405 @@
+//
+//  StatementCacheTests.swift
+//  DeltaTests
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import XCTest
+import SQLite
+
+@testable import Delta
+
+class StatementCacheTests: XCTestCase
+{
+    private static let selectSQL = "SELECT value FROM Items WHERE id = ?"
+    
+    private var connection: Connection!
+    
+    override func setUpWithError() throws
+    {
+        try super.setUpWithError()
+        
+        self.connection = try Connection(.inMemory)
+        try self.connection.execute("CREATE TABLE Items (id INTEGER PRIMARY KEY, value INTEGER)")
+        
+        for id in 0 ..< 10
+        {
+            try self.connection.run("INSERT INTO Items (id, value) VALUES (?, ?)", id, id * 100)
+        }
+    }
+    
+    override func tearDown()
+    {
+        self.connection = nil
+        
+        super.tearDown()
+    }
+}
+
+extension StatementCacheTests
+{
+    func testReusesStatement() throws
+    {
+        let cache = StatementCache(self.connection)
+        
+        let firstStatement = try cache.withStatement(StatementCacheTests.selectSQL, [1]) { $0 }
+        let secondStatement = try cache.withStatement(StatementCacheTests.selectSQL, [2]) { $0 }
+        
+        XCTAssertTrue(firstStatement === secondStatement)
+        XCTAssertEqual(cache.missCount, 1)
+        XCTAssertEqual(cache.hitCount, 1)
+    }
+    
+    func testRebindsReusedStatement() throws
+    {
+        let cache = StatementCache(self.connection)
+        
+        for id in 0 ..< 10
+        {
+            let value = try self.value(forID: id, in: cache)
+            XCTAssertEqual(value, Int64(id * 100))
+        }
+        
+        XCTAssertEqual(cache.missCount, 1)
+        XCTAssertEqual(cache.hitCount, 9)
+    }
+    
+    func testResetsPartiallySteppedStatement() throws
+    {
+        let cache = StatementCache(self.connection)
+        let sql = "SELECT value FROM Items WHERE id >= ? ORDER BY id"
+        
+        // Stop after first row, leaving statement mid-query.
+        let firstValue = try cache.withStatement(sql, [5]) { (statement) -> Int64? in
+            guard try statement.step() else { return nil }
+            return statement.row[0] as Int64
+        }
+        XCTAssertEqual(firstValue, 500)
+        
+        let values = try cache.withStatement(sql, [8]) { (statement) -> [Int64] in
+            var values = [Int64]()
+            while try statement.step()
+            {
+                values.append(statement.row[0] as Int64)
+            }
+            return values
+        }
+        XCTAssertEqual(values, [800, 900])
+        XCTAssertEqual(cache.hitCount, 1)
+    }
+    
+    func testNestedCheckoutsUseSeparateStatements() throws
+    {
+        let cache = StatementCache(self.connection)
+        
+        try cache.withStatement(StatementCacheTests.selectSQL, [1]) { (outerStatement) in
+            try cache.withStatement(StatementCacheTests.selectSQL, [2]) { (innerStatement) in
+                XCTAssertFalse(outerStatement === innerStatement)
+                
+                XCTAssertTrue(try innerStatement.step())
+                XCTAssertEqual(innerStatement.row[0] as Int64, 200)
+            }
+            
+            // Inner checkout must not have disturbed outer statement's bindings.
+            XCTAssertTrue(try outerStatement.step())
+            XCTAssertEqual(outerStatement.row[0] as Int64, 100)
+        }
+        
+        XCTAssertEqual(cache.missCount, 2)
+        
+        // Both statements were returned to the cache.
+        try cache.withStatement(StatementCacheTests.selectSQL, [1]) { _ in
+            try cache.withStatement(StatementCacheTests.selectSQL, [2]) { _ in }
+        }
+        
+        XCTAssertEqual(cache.missCount, 2)
+        XCTAssertEqual(cache.hitCount, 2)
+    }
+    
+    func testCountLimit() throws
+    {
+        let cache = StatementCache(self.connection, countLimit: 1)
+        
+        try cache.withStatement(StatementCacheTests.selectSQL, [1]) { _ in
+            try cache.withStatement(StatementCacheTests.selectSQL, [2]) { _ in }
+        }
+        
+        // Only one of the two statements could be kept.
+        try cache.withStatement(StatementCacheTests.selectSQL, [1]) { _ in
+            try cache.withStatement(StatementCacheTests.selectSQL, [2]) { _ in }
+        }
+        
+        XCTAssertEqual(cache.missCount, 3)
+        XCTAssertEqual(cache.hitCount, 1)
+    }
+    
+    func testRemoveAll() throws
+    {
+        let cache = StatementCache(self.connection)
+        
+        _ = try self.value(forID: 1, in: cache)
+        cache.removeAll()
+        _ = try self.value(forID: 1, in: cache)
+        
+        XCTAssertEqual(cache.missCount, 2)
+        XCTAssertEqual(cache.hitCount, 0)
+    }
+    
+    func testPrepareFailureIsNotCached() throws
+    {
+        let cache = StatementCache(self.connection)
+        
+        XCTAssertThrowsError(try cache.withStatement("SELECT * FROM MissingTable", []) { _ in })
+        XCTAssertThrowsError(try cache.withStatement("SELECT * FROM MissingTable", []) { _ in })
+        
+        XCTAssertEqual(cache.missCount, 2)
+        XCTAssertEqual(cache.hitCount, 0)
+    }
+}
+
+//MARK: - Benchmarks -
+// Compares the query shapes used by GamesDatabase.metadata(for:) and CheatBase.cheats(for:),
+// with and without StatementCache, decoding rows by column name or by column index (like ReleaseRow + CheatRow).
+extension StatementCacheTests
+{
+    func testMetadataQueryPerformanceUncachedByName() throws
+    {
+        try self.measureMetadataQueries(isCached: false, decoding: .byName)
+    }
+    
+    func testMetadataQueryPerformanceUncachedByIndex() throws
+    {
+        try self.measureMetadataQueries(isCached: false, decoding: .byIndex)
+    }
+    
+    func testMetadataQueryPerformanceCachedByName() throws
+    {
+        try self.measureMetadataQueries(isCached: true, decoding: .byName)
+    }
+    
+    func testMetadataQueryPerformanceCachedByIndex() throws
+    {
+        try self.measureMetadataQueries(isCached: true, decoding: .byIndex)
+    }
+    
+    func testCheatsQueryPerformanceUncachedByName() throws
+    {
+        try self.measureCheatsQueries(isCached: false, decoding: .byName)
+    }
+    
+    func testCheatsQueryPerformanceUncachedByIndex() throws
+    {
+        try self.measureCheatsQueries(isCached: false, decoding: .byIndex)
+    }
+    
+    func testCheatsQueryPerformanceCachedByName() throws
+    {
+        try self.measureCheatsQueries(isCached: true, decoding: .byName)
+    }
+    
+    func testCheatsQueryPerformanceCachedByIndex() throws
+    {
+        try self.measureCheatsQueries(isCached: true, decoding: .byIndex)
+    }
+}
+
+private extension StatementCacheTests
+{
+    enum Decoding
+    {
+        // Looks up every column's index by name for every row.
+        case byName
+        
+        // Reads columns by the order they're selected.
+        case byIndex
+    }
+    
+    static let benchmarkROMCount = 1_000
+    static let benchmarkCheatsPerROM = 50
+    static let benchmarkCategoryCount = 10
+    
+    func measureMetadataQueries(isCached: Bool, decoding: Decoding) throws
+    {
+        let connection = try self.makeBenchmarkDatabase()
+        let cache = isCached ? StatementCache(connection) : nil
+        
+        let releaseID = SQLite.Expression<Any>.releaseID
+        let name = SQLite.Expression<Any>.name
+        let artworkAddress = SQLite.Expression<Any>.artworkAddress
+        let sha1Hash = SQLite.Expression<Any>.sha1Hash
+        let romID = SQLite.Expression<Any>.romID
+        
+        let hashes = (0 ..< StatementCacheTests.benchmarkROMCount).map { String(format: "%040X", $0) }
+        
+        self.measure {
+            var metadata = [GameMetadata]()
+            
+            do
+            {
+                // Same query metadata(forSHA1Hashes:) performs for a single game.
+                for hash in hashes
+                {
+                    let query = Table.roms.select(sha1Hash, releaseID, name, artworkAddress, Table.roms[romID]).filter([hash].contains(sha1Hash)).join(Table.releases, on: Table.roms[romID] == Table.releases[romID])
+                    
+                    try self.forEachRow(in: query, connection: connection, cache: cache) { (statement) in
+                        let column = self.columnIndexes(in: statement, decoding: decoding)
+                        let cursor = statement.row
+                        
+                        let artworkAddress = cursor[column("releaseCoverFront", 3)] as Binding? as? String
+                        let gameMetadata = GameMetadata(releaseID: cursor[column("releaseID", 1)],
+                                                        romID: cursor[column("romID", 4)],
+                                                        name: cursor[column("releaseTitleName", 2)] as Binding? as? String,
+                                                        artworkURL: artworkAddress.flatMap { URL(string: $0) })
+                        metadata.append(gameMetadata)
+                    }
+                }
+            }
+            catch
+            {
+                XCTFail(error.localizedDescription)
+            }
+            
+            XCTAssertEqual(metadata.count, hashes.count)
+        }
+    }
+    
+    func measureCheatsQueries(isCached: Bool, decoding: Decoding) throws
+    {
+        let connection = try self.makeBenchmarkDatabase()
+        let cache = isCached ? StatementCache(connection) : nil
+        
+        let cheatID = SQLite.Expression<Any>.cheatID
+        let cheatName = SQLite.Expression<Any>.cheatName
+        let cheatCode = SQLite.Expression<Any>.cheatCode
+        let cheatDescription = SQLite.Expression<Any>.cheatDescription
+        let cheatActivation = SQLite.Expression<Any>.cheatActivation
+        let cheatDeviceID = SQLite.Expression<Any>.cheatDeviceID
+        let categoryID = SQLite.Expression<Any>.cheatCategoryID
+        let categoryName = SQLite.Expression<Any>.cheatCategoryName
+        let categoryDescription = SQLite.Expression<Any>.cheatCategoryDescription
+        let romID = SQLite.Expression<Any>.romID
+        
+        self.measure {
+            var cheats = [CheatMetadata]()
+            
+            do
+            {
+                // Same query cheats(for:) performs.
+                for romIDValue in 0 ..< StatementCacheTests.benchmarkROMCount
+                {
+                    let query = Table.cheats.select(cheatID, cheatName, cheatCode, cheatDescription, cheatActivation, cheatDeviceID, Table.cheats[categoryID], categoryName, categoryDescription)
+                        .filter(romID == romIDValue)
+                        .join(Table.cheatCategories, on: Table.cheats[categoryID] == Table.cheatCategories[categoryID])
+                        .order(cheatName)
+                    
+                    try self.forEachRow(in: query, connection: connection, cache: cache) { (statement) in
+                        let column = self.columnIndexes(in: statement, decoding: decoding)
+                        let cursor = statement.row
+                        
+                        let deviceID: Int = cursor[column("cheatDeviceID", 5)]
+                        guard let device = CheatDevice(rawValue: Int16(deviceID)) else { return }
+                        
+                        let category = CheatCategory(id: cursor[column("cheatCategoryID", 6)], name: cursor[column("cheatCategory", 7)], categoryDescription: cursor[column("cheatCategoryDescription", 8)])
+                        let metadata = CheatMetadata(id: cursor[column("cheatID", 0)],
+                                                     name: cursor[column("cheatName", 1)],
+                                                     code: cursor[column("cheatCode", 2)],
+                                                     description: cursor[column("cheatDescription", 3)] as Binding? as? String,
+                                                     activationHint: cursor[column("cheatActivation", 4)] as Binding? as? String,
+                                                     device: device,
+                                                     category: category)
+                        cheats.append(metadata)
+                    }
+                }
+            }
+            catch
+            {
+                XCTFail(error.localizedDescription)
+            }
+            
+            XCTAssertEqual(cheats.count, StatementCacheTests.benchmarkROMCount * StatementCacheTests.benchmarkCheatsPerROM)
+        }
+    }
+    
+    // Uncached queries prepare a new statement every time, like Connection.prepare(_: QueryType).
+    func forEachRow(in query: QueryType, connection: Connection, cache: StatementCache?, body: (Statement) throws -> Void) throws
+    {
+        let expression = query.expression
+        
+        if let cache
+        {
+            try cache.withStatement(expression.template, expression.bindings) { (statement) -> Void in
+                while try statement.step()
+                {
+                    try body(statement)
+                }
+            }
+        }
+        else
+        {
+            let statement = try connection.prepare(expression.template, expression.bindings)
+            while try statement.step()
+            {
+                try body(statement)
+            }
+        }
+    }
+    
+    // Maps (column name, selected index) to the index used to read that column.
+    func columnIndexes(in statement: Statement, decoding: Decoding) -> (String, Int) -> Int
+    {
+        switch decoding
+        {
+        case .byIndex: return { (_, index) in index }
+        case .byName: return { (name, _) in statement.columnNames.firstIndex(of: name) ?? -1 }
+        }
+    }
+    
+    func makeBenchmarkDatabase() throws -> Connection
+    {
+        let connection = try Connection(.inMemory)
+        
+        // Minimal subsets of the OpenVGDB + CheatBase schemas, with the indexes GamesDatabase + CheatBase build.
+        try connection.execute("""
+            CREATE TABLE ROMs (romID INTEGER PRIMARY KEY, romHashSHA1 TEXT);
+            CREATE TABLE RELEASES (releaseID INTEGER PRIMARY KEY, romID INTEGER, releaseTitleName TEXT, releaseCoverFront TEXT);
+            CREATE TABLE CHEATS (cheatID INTEGER PRIMARY KEY, romID INTEGER, cheatName TEXT, cheatCode TEXT, cheatDescription TEXT, cheatActivation TEXT, cheatDeviceID INTEGER, cheatCategoryID INTEGER);
+            CREATE TABLE CHEAT_CATEGORIES (cheatCategoryID INTEGER PRIMARY KEY, cheatCategory TEXT, cheatCategoryDescription TEXT);
+            CREATE INDEX ROMsHashIndex ON ROMs (romHashSHA1, romID);
+            CREATE INDEX RELEASESRomIndex ON RELEASES (romID);
+            CREATE INDEX CHEATSRomIndex ON CHEATS (romID);
+            """)
+        
+        let deviceID = Int(CheatDevice.famicomGameGenie.rawValue)
+        
+        try connection.transaction {
+            for categoryID in 0 ..< StatementCacheTests.benchmarkCategoryCount
+            {
+                try connection.run("INSERT INTO CHEAT_CATEGORIES VALUES (?, ?, ?)", categoryID, "Category \(categoryID)", "Description \(categoryID)")
+            }
+            
+            for romID in 0 ..< StatementCacheTests.benchmarkROMCount
+            {
+                try connection.run("INSERT INTO ROMs VALUES (?, ?)", romID, String(format: "%040X", romID))
+                try connection.run("INSERT INTO RELEASES VALUES (?, ?, ?, ?)", romID, romID, "Game \(romID)", "https://example.com/\(romID).png")
+                
+                for index in 0 ..< StatementCacheTests.benchmarkCheatsPerROM
+                {
+                    let cheatID = romID * StatementCacheTests.benchmarkCheatsPerROM + index
+                    try connection.run("INSERT INTO CHEATS VALUES (?, ?, ?, ?, ?, ?, ?, ?)", cheatID, romID, "Cheat \(index)", "00000000", "Description", nil, deviceID, index % StatementCacheTests.benchmarkCategoryCount)
+                }
+            }
+        }
+        
+        return connection
+    }
+    
+    func value(forID id: Int, in cache: StatementCache) throws -> Int64?
+    {
+        return try cache.withStatement(StatementCacheTests.selectSQL, [id]) { (statement) -> Int64? in
+            guard try statement.step() else { return nil }
+            return statement.row[0] as Int64
+        }
+    }
+}
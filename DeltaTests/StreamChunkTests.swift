@@ -0,0 +1,563 @@
+//
+//  StreamChunkTests.swift
+//  DeltaTests
+//
+//  Created by Riley Testut on 10/17/26.
+//  Copyright © 2026 Riley Testut. All rights reserved.
+//
+
+import XCTest
+
+@testable import Delta
+
+class StreamChunkTests: XCTestCase
+{
+    private var temporaryDirectory: URL!
+    
+    override func setUpWithError() throws
+    {
+        try super.setUpWithError()
+        
+        self.temporaryDirectory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: self.temporaryDirectory, withIntermediateDirectories: true)
+    }
+    
+    override func tearDownWithError() throws
+    {
+        try? FileManager.default.removeItem(at: self.temporaryDirectory)
+        
+        try super.tearDownWithError()
+    }
+}
+
+//MARK: - Chunks -
+extension StreamChunkTests
+{
+    func testHeaderRoundTrip()
+    {
+        let header = StreamChunk.Header(flags: .compressed, payloadSize: 1234, originalSize: 5678, checksum: 0xDEADBEEF, offset: 3 * StreamChunk.maximumSize, fileSize: Int(UInt32.max) + 10)
+        
+        let data = header.data()
+        XCTAssertEqual(data.count, StreamChunk.Header.size)
+        XCTAssertEqual(data.count, 32)
+        
+        let decodedHeader = StreamChunk.Header(data: data)
+        XCTAssertEqual(decodedHeader.flags, header.flags)
+        XCTAssertEqual(decodedHeader.payloadSize, header.payloadSize)
+        XCTAssertEqual(decodedHeader.originalSize, header.originalSize)
+        XCTAssertEqual(decodedHeader.checksum, header.checksum)
+        XCTAssertEqual(decodedHeader.offset, header.offset)
+        XCTAssertEqual(decodedHeader.fileSize, header.fileSize)
+    }
+    
+    func testCompressesCompressibleData() throws
+    {
+        let data = StreamChunkTests.compressibleData(count: StreamChunk.maximumSize)
+        
+        let chunk = StreamChunk(data: data, offset: 0, fileSize: data.count, compress: true)
+        XCTAssertTrue(chunk.header.flags.contains(.compressed))
+        XCTAssertLessThan(chunk.payload.count, data.count)
+        XCTAssertEqual(chunk.header.payloadSize, chunk.payload.count)
+        XCTAssertEqual(chunk.header.originalSize, data.count)
+        
+        XCTAssertEqual(try chunk.decodedData(), data)
+    }
+    
+    func testSendsIncompressibleDataUncompressed() throws
+    {
+        let data = StreamChunkTests.randomData(count: 64 * 1024)
+        
+        let chunk = StreamChunk(data: data, offset: 0, fileSize: data.count, compress: true)
+        XCTAssertFalse(chunk.header.flags.contains(.compressed))
+        XCTAssertEqual(chunk.payload, data)
+        
+        XCTAssertEqual(try chunk.decodedData(), data)
+    }
+    
+    func testCorruptedChunkThrows()
+    {
+        let data = StreamChunkTests.randomData(count: 1024)
+        
+        var chunk = StreamChunk(data: data, offset: 0, fileSize: data.count, compress: false)
+        chunk.payload[100] ^= 0xFF
+        
+        XCTAssertThrowsError(try chunk.decodedData())
+    }
+    
+    func testCorruptedCompressedChunkThrows()
+    {
+        let data = StreamChunkTests.compressibleData(count: 64 * 1024)
+        
+        var chunk = StreamChunk(data: data, offset: 0, fileSize: data.count, compress: true)
+        XCTAssertTrue(chunk.header.flags.contains(.compressed))
+        
+        chunk.header.checksum ^= 1
+        
+        XCTAssertThrowsError(try chunk.decodedData())
+    }
+}
+
+//MARK: - Streams -
+extension StreamChunkTests
+{
+    func testSendAndReceiveFile() async throws
+    {
+        // Not a multiple of maximumSize, so final chunk is partial.
+        let data = StreamChunkTests.randomData(count: 2 * StreamChunk.maximumSize + 12345)
+        try await self.verifyRoundTrip(of: data, compress: false)
+    }
+    
+    func testSendAndReceiveCompressedFile() async throws
+    {
+        let data = StreamChunkTests.compressibleData(count: 2 * StreamChunk.maximumSize + 12345)
+        try await self.verifyRoundTrip(of: data, compress: true)
+    }
+    
+    func testSendAndReceiveEmptyFile() async throws
+    {
+        try await self.verifyRoundTrip(of: Data(), compress: true)
+    }
+    
+    func testReceiveLegacyFile() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 4096)
+        
+        var streamData = withUnsafeBytes(of: Int32(data.count)) { Data($0) }
+        streamData.append(data)
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Legacy")
+        let progress = Progress(totalUnitCount: 0)
+        
+        try await self.receiveFile(from: streamData, to: fileURL, progress: progress)
+        
+        XCTAssertEqual(try Data(contentsOf: fileURL), data)
+        XCTAssertEqual(progress.completedUnitCount, Int64(data.count))
+    }
+}
+
+//MARK: - Interrupted Transfers -
+extension StreamChunkTests
+{
+    func testReceiveRejectsMissingChunk() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        var chunks = StreamChunkTests.chunks(for: data, chunkSize: 1024)
+        chunks.remove(at: 1)
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Missing")
+        await self.assertReceiveFileThrows(from: StreamChunkTests.streamData(for: chunks), to: fileURL)
+    }
+    
+    func testReceiveRejectsReorderedChunks() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        var chunks = StreamChunkTests.chunks(for: data, chunkSize: 1024)
+        chunks.swapAt(0, 1)
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Reordered")
+        await self.assertReceiveFileThrows(from: StreamChunkTests.streamData(for: chunks), to: fileURL)
+    }
+    
+    func testReceiveRejectsMissingEndChunk() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        var chunks = StreamChunkTests.chunks(for: data, chunkSize: 1024)
+        chunks.removeLast()
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Unterminated")
+        await self.assertReceiveFileThrows(from: StreamChunkTests.streamData(for: chunks), to: fileURL)
+    }
+    
+    func testReceiveRejectsEndChunkWithDifferentFileSize() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        // Sender claims file is larger than what it actually sent.
+        var chunks = StreamChunkTests.chunks(for: data, chunkSize: 1024)
+        chunks[chunks.count - 1].header.fileSize += 1024
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Short")
+        await self.assertReceiveFileThrows(from: StreamChunkTests.streamData(for: chunks), to: fileURL)
+    }
+    
+    func testReceiveRejectsTruncatedStream() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        let streamData = StreamChunkTests.streamData(for: StreamChunkTests.chunks(for: data, chunkSize: 1024))
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Truncated")
+        
+        // Cut off mid-header and mid-payload.
+        for count in [2, 4 + StreamChunk.Header.size / 2, 4 + StreamChunk.Header.size + 512, streamData.count - 1]
+        {
+            await self.assertReceiveFileThrows(from: streamData.prefix(count), to: fileURL)
+        }
+    }
+    
+    func testReceiveReplacesExistingFile() async throws
+    {
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Existing")
+        try StreamChunkTests.randomData(count: 8 * 1024).write(to: fileURL)
+        
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        try await self.receiveFile(from: StreamChunkTests.streamData(for: StreamChunkTests.chunks(for: data, chunkSize: 1024)), to: fileURL)
+        
+        XCTAssertEqual(try Data(contentsOf: fileURL), data)
+    }
+}
+
+//MARK: - Resuming Transfers -
+// Transfers through bound stream pairs, with a relay in between that simulates dropped connections.
+extension StreamChunkTests
+{
+    func testResumeInterruptedTransfer() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * StreamChunk.maximumSize + 12345)
+        
+        let sourceURL = self.temporaryDirectory.appendingPathComponent("Source")
+        let destinationURL = self.temporaryDirectory.appendingPathComponent("Destination")
+        try data.write(to: sourceURL)
+        
+        // Drop connection halfway through second chunk.
+        await self.assertTransferFileThrows(at: sourceURL, to: destinationURL, compress: false, dropAfter: StreamChunk.maximumSize * 3 / 2)
+        
+        // Only first (verified) chunk was kept.
+        let offset = try XCTUnwrap(destinationURL.resourceValues(forKeys: [.fileSizeKey]).fileSize)
+        XCTAssertEqual(offset, StreamChunk.maximumSize)
+        XCTAssertEqual(try Data(contentsOf: destinationURL), data.prefix(offset))
+        
+        let progress = Progress(totalUnitCount: 0)
+        try await self.transferFile(at: sourceURL, to: destinationURL, offset: offset, compress: false, progress: progress)
+        
+        XCTAssertEqual(try Data(contentsOf: destinationURL), data)
+        XCTAssertEqual(progress.totalUnitCount, Int64(data.count))
+        XCTAssertEqual(progress.completedUnitCount, Int64(data.count))
+    }
+    
+    func testResumeAfterRepeatedDrops() async throws
+    {
+        // Mix of compressible + incompressible chunks.
+        var data = StreamChunkTests.compressibleData(count: 2 * StreamChunk.maximumSize)
+        data.append(StreamChunkTests.randomData(count: 3 * StreamChunk.maximumSize + 12345))
+        
+        let sourceURL = self.temporaryDirectory.appendingPathComponent("Source")
+        let destinationURL = self.temporaryDirectory.appendingPathComponent("Destination")
+        try data.write(to: sourceURL)
+        
+        var offset = 0
+        var isFinished = false
+        
+        for _ in 0 ..< 10
+        {
+            do
+            {
+                try await self.transferFile(at: sourceURL, to: destinationURL, offset: offset, compress: true, dropAfter: StreamChunk.maximumSize * 3 / 2)
+                isFinished = true
+                break
+            }
+            catch
+            {
+                let fileSize = try XCTUnwrap(destinationURL.resourceValues(forKeys: [.fileSizeKey]).fileSize)
+                XCTAssertGreaterThan(fileSize, offset, "Transfer made no progress.")
+                XCTAssertEqual(try Data(contentsOf: destinationURL), data.prefix(fileSize))
+                
+                offset = fileSize
+            }
+        }
+        
+        XCTAssertTrue(isFinished)
+        XCTAssertEqual(try Data(contentsOf: destinationURL), data)
+    }
+    
+    func testRestartTransferIfSenderCannotResume() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * StreamChunk.maximumSize)
+        
+        let sourceURL = self.temporaryDirectory.appendingPathComponent("Source")
+        let destinationURL = self.temporaryDirectory.appendingPathComponent("Destination")
+        try data.write(to: sourceURL)
+        
+        await self.assertTransferFileThrows(at: sourceURL, to: destinationURL, compress: false, dropAfter: StreamChunk.maximumSize * 5 / 2)
+        
+        let offset = try XCTUnwrap(destinationURL.resourceValues(forKeys: [.fileSizeKey]).fileSize)
+        XCTAssertEqual(offset, 2 * StreamChunk.maximumSize)
+        
+        // Sender no longer has same file (e.g. game changed), so sends a different file from the beginning.
+        let replacementData = StreamChunkTests.randomData(count: StreamChunk.maximumSize + 12345)
+        try replacementData.write(to: sourceURL)
+        
+        try await self.transferFile(at: sourceURL, to: destinationURL, senderOffset: 0, receiverOffset: offset, compress: false)
+        XCTAssertEqual(try Data(contentsOf: destinationURL), replacementData)
+    }
+    
+    func testReceiveRejectsChunkAfterResumeOffset() async throws
+    {
+        let data = StreamChunkTests.randomData(count: 3 * 1024)
+        
+        let fileURL = self.temporaryDirectory.appendingPathComponent("Gap")
+        try data.prefix(1024).write(to: fileURL)
+        
+        // Receiver has first chunk, but sender skips to third.
+        let chunks = Array(StreamChunkTests.chunks(for: data, chunkSize: 1024).dropFirst(2))
+        
+        let inputStream = InputStream(data: StreamChunkTests.streamData(for: chunks))
+        inputStream.open()
+        defer { inputStream.close() }
+        
+        do
+        {
+            try await inputStream.receiveFile(to: fileURL, offset: 1024)
+            XCTFail("Received file with missing chunk without throwing.")
+        }
+        catch
+        {
+            // Expected
+        }
+    }
+}
+
+//MARK: - Benchmarks -
+// Moves a 32MB file through a bound stream pair, with sender and receiver running concurrently like during Handoff.
+extension StreamChunkTests
+{
+    func testLoopbackTransferPerformance() throws
+    {
+        try self.measureLoopbackTransfer(compress: false)
+    }
+    
+    func testCompressedLoopbackTransferPerformance() throws
+    {
+        try self.measureLoopbackTransfer(compress: true)
+    }
+}
+
+private extension StreamChunkTests
+{
+    static func randomData(count: Int) -> Data
+    {
+        var generator = SystemRandomNumberGenerator()
+        return Data((0 ..< count).map { _ in UInt8.random(in: .min ... .max, using: &generator) })
+    }
+    
+    static func compressibleData(count: Int) -> Data
+    {
+        return Data((0 ..< count).map { UInt8(truncatingIfNeeded: $0 / 64) })
+    }
+    
+    // Chunks (including end chunk) as sent by OutputStream.sendFile(at:compress:progress:).
+    static func chunks(for data: Data, chunkSize: Int) -> [StreamChunk]
+    {
+        var chunks = stride(from: 0, to: data.count, by: chunkSize).map { (offset) -> StreamChunk in
+            let chunkData = data.subdata(in: offset ..< min(offset + chunkSize, data.count))
+            return StreamChunk(data: chunkData, offset: offset, fileSize: data.count, compress: false)
+        }
+        
+        chunks.append(.end(fileSize: data.count))
+        return chunks
+    }
+    
+    static func streamData(for chunks: [StreamChunk]) -> Data
+    {
+        var streamData = Data()
+        
+        for chunk in chunks
+        {
+            withUnsafeBytes(of: StreamChunk.magic.littleEndian) { streamData.append(contentsOf: $0) }
+            streamData.append(chunk.header.data())
+            streamData.append(chunk.payload)
+        }
+        
+        return streamData
+    }
+    
+    func verifyRoundTrip(of data: Data, compress: Bool) async throws
+    {
+        let sourceURL = self.temporaryDirectory.appendingPathComponent("Source")
+        let destinationURL = self.temporaryDirectory.appendingPathComponent("Destination")
+        try data.write(to: sourceURL)
+        
+        let outputStream = OutputStream(toMemory: ())
+        outputStream.open()
+        defer { outputStream.close() }
+        
+        try await outputStream.sendFile(at: sourceURL, compress: compress)
+        
+        let streamData = try XCTUnwrap(outputStream.property(forKey: .dataWrittenToMemoryStreamKey) as? Data)
+        if compress && !data.isEmpty
+        {
+            XCTAssertLessThan(streamData.count, data.count)
+        }
+        
+        let progress = Progress(totalUnitCount: 0)
+        try await self.receiveFile(from: streamData, to: destinationURL, progress: progress)
+        
+        XCTAssertEqual(try Data(contentsOf: destinationURL), data)
+        XCTAssertEqual(progress.totalUnitCount, Int64(data.count))
+        XCTAssertEqual(progress.completedUnitCount, Int64(data.count))
+    }
+    
+    func measureLoopbackTransfer(compress: Bool) throws
+    {
+        // Mostly compressible, like typical save states.
+        let data = StreamChunkTests.compressibleData(count: 32 * 1024 * 1024)
+        
+        let sourceURL = self.temporaryDirectory.appendingPathComponent("Source")
+        let destinationURL = self.temporaryDirectory.appendingPathComponent("Destination")
+        try data.write(to: sourceURL)
+        
+        self.measure {
+            let expectation = self.expectation(description: "Transferred file")
+            
+            Task<Void, Never> {
+                do
+                {
+                    try await self.transferFile(at: sourceURL, to: destinationURL, compress: compress)
+                }
+                catch
+                {
+                    XCTFail(error.localizedDescription)
+                }
+                
+                expectation.fulfill()
+            }
+            
+            self.wait(for: [expectation], timeout: 60.0)
+        }
+        
+        XCTAssertEqual(try Data(contentsOf: destinationURL), data)
+    }
+    
+    func transferFile(at sourceURL: URL, to destinationURL: URL, offset: Int = 0, compress: Bool, progress: Progress? = nil, dropAfter: Int? = nil) async throws
+    {
+        try await self.transferFile(at: sourceURL, to: destinationURL, senderOffset: offset, receiverOffset: offset, compress: compress, progress: progress, dropAfter: dropAfter)
+    }
+    
+    // Bound streams block when buffer is full (or empty), so sender, relay, and receiver must run concurrently.
+    // If dropAfter is non-nil, relay closes receiver's stream after forwarding that many bytes, like a dropped connection.
+    func transferFile(at sourceURL: URL, to destinationURL: URL, senderOffset: Int, receiverOffset: Int, compress: Bool, progress: Progress? = nil, dropAfter: Int? = nil) async throws
+    {
+        let (receiverInputStream, relayOutputStream) = try StreamChunkTests.makeBoundStreams()
+        defer { receiverInputStream.close() }
+        
+        let senderOutputStream: OutputStream
+        let relayTask: Task<Void, Never>?
+        
+        if let dropAfter
+        {
+            let (relayInputStream, outputStream) = try StreamChunkTests.makeBoundStreams()
+            senderOutputStream = outputStream
+            
+            relayTask = Task.detached {
+                StreamChunkTests.relay(from: relayInputStream, to: relayOutputStream, dropAfter: dropAfter)
+            }
+        }
+        else
+        {
+            senderOutputStream = relayOutputStream
+            relayTask = nil
+        }
+        
+        let sendTask = Task.detached {
+            defer { senderOutputStream.close() }
+            try await senderOutputStream.sendFile(at: sourceURL, offset: senderOffset, compress: compress)
+        }
+        
+        // If receiving fails, sender + relay still finish on their own, since relay keeps reading until sender is done.
+        try await receiverInputStream.receiveFile(to: destinationURL, offset: receiverOffset, progress: progress)
+        
+        try await sendTask.value
+        await relayTask?.value
+    }
+    
+    func assertTransferFileThrows(at sourceURL: URL, to destinationURL: URL, compress: Bool, dropAfter: Int, file: StaticString = #filePath, line: UInt = #line) async
+    {
+        do
+        {
+            try await self.transferFile(at: sourceURL, to: destinationURL, compress: compress, dropAfter: dropAfter)
+            XCTFail("Transfer succeeded despite dropped connection.", file: file, line: line)
+        }
+        catch
+        {
+            // Expected
+        }
+    }
+    
+    static func makeBoundStreams() throws -> (InputStream, OutputStream)
+    {
+        var inputStream: InputStream?
+        var outputStream: OutputStream?
+        Stream.getBoundStreams(withBufferSize: 64 * 1024, inputStream: &inputStream, outputStream: &outputStream)
+        
+        guard let inputStream, let outputStream else { throw CocoaError(.fileWriteUnknown) }
+        
+        inputStream.open()
+        outputStream.open()
+        
+        return (inputStream, outputStream)
+    }
+    
+    // Forwards everything sender writes until dropAfter bytes, then closes outputStream but keeps reading so sender never blocks.
+    static func relay(from inputStream: InputStream, to outputStream: OutputStream, dropAfter: Int)
+    {
+        defer {
+            inputStream.close()
+            outputStream.close()
+        }
+        
+        var buffer = [UInt8](repeating: 0, count: 64 * 1024)
+        var forwardedCount = 0
+        var isConnected = true
+        
+        while true
+        {
+            let count = inputStream.read(&buffer, maxLength: buffer.count)
+            guard count > 0 else { break }
+            
+            guard isConnected else { continue }
+            
+            let forwardCount = min(count, dropAfter - forwardedCount)
+            
+            var offset = 0
+            while offset < forwardCount
+            {
+                let writtenCount = buffer.withUnsafeBufferPointer { outputStream.write($0.baseAddress! + offset, maxLength: forwardCount - offset) }
+                guard writtenCount > 0 else { break }
+                
+                offset += writtenCount
+            }
+            
+            forwardedCount += offset
+            
+            if forwardedCount >= dropAfter || offset < forwardCount
+            {
+                isConnected = false
+                outputStream.close()
+            }
+        }
+    }
+    
+    func receiveFile(from streamData: Data, to fileURL: URL, progress: Progress? = nil) async throws
+    {
+        let inputStream = InputStream(data: streamData)
+        inputStream.open()
+        defer { inputStream.close() }
+        
+        try await inputStream.receiveFile(to: fileURL, progress: progress)
+    }
+    
+    func assertReceiveFileThrows(from streamData: Data, to fileURL: URL, file: StaticString = #filePath, line: UInt = #line) async
+    {
+        do
+        {
+            try await self.receiveFile(from: streamData, to: fileURL)
+            XCTFail("Received incomplete file without throwing.", file: file, line: line)
+        }
+        catch
+        {
+            // Expected
+        }
+    }
+}
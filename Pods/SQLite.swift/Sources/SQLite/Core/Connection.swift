@@ -104,7 +104,8 @@ public final class Connection {
     /// - Returns: A new database connection.
     public init(_ location: Location = .inMemory, readonly: Bool = false) throws {
         let flags = readonly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE
-        try check(sqlite3_open_v2(location.description, &_handle, flags | SQLITE_OPEN_FULLMUTEX, nil))
+        // SQLITE_OPEN_URI so "file:" locations can specify query parameters (e.g. mode=ro, immutable=1).
+        try check(sqlite3_open_v2(location.description, &_handle, flags | SQLITE_OPEN_FULLMUTEX | SQLITE_OPEN_URI, nil))
         queue.setSpecific(key: Connection.queueKey, value: queueContext)
     }
 
@@ -407,6 +408,32 @@ public final class Connection {
     fileprivate typealias BusyHandler = @convention(block) (Int32) -> Int32
     fileprivate var busyHandler: BusyHandler?
 
+    /// Sets a handler to call periodically during long-running queries.
+    ///
+    /// - Parameters:
+    ///
+    ///   - instructions: The approximate number of virtual machine
+    ///     instructions evaluated between invocations of `callback`.
+    ///
+    ///   - callback: This block is executed periodically while a statement
+    ///     is running. If it returns `true`, the statement is interrupted and
+    ///     fails with `SQLITE_INTERRUPT`.
+    public func progressHandler(every instructions: Int = 1_000, _ callback: (() -> Bool)?) {
+        guard let callback = callback else {
+            sqlite3_progress_handler(handle, 0, nil, nil)
+            progressHandler = nil
+            return
+        }
+
+        let box: ProgressHandler = { callback() ? 1 : 0 }
+        sqlite3_progress_handler(handle, Int32(instructions), { callback in
+            unsafeBitCast(callback, to: ProgressHandler.self)()
+        }, unsafeBitCast(box, to: UnsafeMutableRawPointer.self))
+        progressHandler = box
+    }
+    fileprivate typealias ProgressHandler = @convention(block) () -> Int32
+    fileprivate var progressHandler: ProgressHandler?
+
     /// Sets a handler to call when a statement is executed with the compiled
     /// SQL.
     ///
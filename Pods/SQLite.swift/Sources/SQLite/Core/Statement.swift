@@ -22,6 +22,7 @@
 // THE SOFTWARE.
 //
 
+import Foundation
 #if SQLITE_SWIFT_STANDALONE
 import sqlite3
 #elseif SQLITE_SWIFT_SQLCIPHER
@@ -186,7 +187,7 @@ public final class Statement {
         return try connection.sync { try self.connection.check(sqlite3_step(self.handle)) == SQLITE_ROW }
     }
 
-    fileprivate func reset(clearBindings shouldClear: Bool = true) {
+    func reset(clearBindings shouldClear: Bool = true) {
         sqlite3_reset(handle)
         if (shouldClear) { sqlite3_clear_bindings(handle) }
     }
@@ -236,6 +237,87 @@ extension Statement : CustomStringConvertible {
 
 }
 
+/// Caches prepared statements by their SQL text, so repeated queries don't need to be re-prepared.
+///
+/// Statements are checked out of the cache for the duration of `withStatement(_:_:_:)`, so a cache
+/// may be shared between threads without two callers ever stepping the same statement.
+public final class StatementCache {
+
+    public let connection: Connection
+
+    /// The maximum number of idle statements kept in the cache.
+    public let countLimit: Int
+
+    /// The number of requests satisfied by a previously prepared statement.
+    public private(set) var hitCount = 0
+
+    /// The number of requests that required preparing a new statement.
+    public private(set) var missCount = 0
+
+    fileprivate var statements = [String: [Statement]]()
+    fileprivate var count = 0
+    fileprivate let lock = NSLock()
+
+    public init(_ connection: Connection, countLimit: Int = 32) {
+        self.connection = connection
+        self.countLimit = countLimit
+    }
+
+    /// Binds parameters to a (possibly cached) statement for the given SQL and passes it to `block`.
+    ///
+    /// The statement is returned to the cache once `block` returns, so it must not escape `block`.
+    public func withStatement<T>(_ SQL: String, _ bindings: [Binding?], _ block: (Statement) throws -> T) throws -> T {
+        let statement = try dequeueStatement(SQL)
+        defer { enqueueStatement(statement, forSQL: SQL) }
+
+        statement.reset()
+        _ = statement.bind(bindings)
+
+        return try block(statement)
+    }
+
+    /// Finalizes all idle statements.
+    public func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        statements.removeAll()
+        count = 0
+    }
+
+    fileprivate func dequeueStatement(_ SQL: String) throws -> Statement {
+        lock.lock()
+
+        if var cachedStatements = statements[SQL], let statement = cachedStatements.popLast() {
+            statements[SQL] = cachedStatements
+            count -= 1
+            hitCount += 1
+            lock.unlock()
+
+            return statement
+        }
+
+        missCount += 1
+        lock.unlock()
+
+        return try connection.prepare(SQL)
+    }
+
+    fileprivate func enqueueStatement(_ statement: Statement, forSQL SQL: String) {
+        // Release any references to bound values and step state before caching.
+        statement.reset()
+
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard count < countLimit else { return }
+
+        statements[SQL, default: []].append(statement)
+        count += 1
+    }
+
+}
+
 public struct Cursor {
 
     fileprivate let handle: OpaquePointer